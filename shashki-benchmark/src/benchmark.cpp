@@ -1,48 +1,568 @@
 #include <iostream>
 #include <vector>
 #include <chrono>
+#include <thread>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <optional>
+#include <filesystem>
+#include <unordered_set>
 #include "shashki-engine/common.hpp"
 #include "shashki-engine/move-generation.hpp"
 #include "shashki-engine/engine.hpp"
+#include "shashki-engine/perft.hpp"
+#include "shashki-engine/validation.hpp"
+#include "shashki-engine/opening-explorer.hpp"
+#include "shashki-engine/adjudication.hpp"
+#include "shashki-engine/evaluation.hpp"
+#include "shashki-engine/search.hpp"
+#include "shashki-engine/threats.hpp"
+#include "shashki-engine/position-set.hpp"
 
-const int MAX_BOARDS_MOVE_GENERATION = 10000000;
+const int PERFT_DEPTH = 11;
+const std::size_t PERFT_HASH_ENTRIES = 1 << 22;
 
 void benchmark_move_generation()
 {
-    std::cout << "Preparing for move-generation benchmark...\n";
-    
-    std::vector<shashki::BitBoard> test_bit_boards = std::vector<shashki::BitBoard>();
-    shashki::Game game = shashki::Game();
+    unsigned int thread_count = std::max(std::thread::hardware_concurrency(), 1U);
 
-    while (test_bit_boards.size() < MAX_BOARDS_MOVE_GENERATION) {
-        if (shashki::generate_moves_for_game(game).size() == 0) {
-            game = shashki::Game();
+    std::cout << "Starting move-generation (perft) benchmark...\n";
+    std::cout << "Perft depth " << PERFT_DEPTH << " from the start position on " << thread_count << " threads.\n";
+
+    shashki::PerftResult perft_result = shashki::fast_perft(shashki::Position(), PERFT_DEPTH, thread_count, PERFT_HASH_ENTRIES);
+
+    std::cout << "Move-generation benchmark finished.\n";
+    std::cout << "Perft counted " << perft_result.nodes << " nodes.\n";
+    std::cout << "Move-generation benchmark took " << perft_result.milliseconds << " milliseconds.\n";
+    std::cout << "Move-generation throughput is " << perft_result.nodes_per_second << " nodes per second.\n\n";
+}
+
+const int VALIDATION_GAMES = 100000;
+const int VALIDATION_MAX_PLIES = 150;
+
+/**
+ * Plays a game with random moves and records it with PackedMoves.
+ */
+shashki::GameRecord random_game_record(std::mt19937_64& random_number_generator)
+{
+    shashki::GameRecord game_record = shashki::GameRecord();
+    shashki::Position position = game_record.start_position;
+
+    for (int ply = 0; ply < VALIDATION_MAX_PLIES; ply++) {
+        std::vector<shashki::BitBoard> bit_boards = shashki::generate_bit_boards_for_position(position);
+
+        if (bit_boards.empty()) {
+            break;
         }
 
-        shashki::Move random_move = shashki::random_move(game);
-        game.execute_move(random_move);
-        test_bit_boards.push_back(game.get_bit_board());
+        std::uniform_int_distribution<std::size_t> random_distribution = std::uniform_int_distribution<std::size_t>(0, bit_boards.size() - 1);
+        shashki::BitBoard target_bit_board = bit_boards[random_distribution(random_number_generator)];
+
+        game_record.moves.push_back(shashki::packed_move_between(position, target_bit_board));
+        position = shashki::Position(target_bit_board, shashki::side_opposite(position.current_turn));
     }
 
-    std::cout << "Preparation for move-generation benchmark finished.\n";
-    std::cout << "Starting move-generation benchmark...\n";
+    // A side without any moves left has lost the game.
+    if (shashki::generate_bit_boards_for_position(position).empty()) {
+        game_record.result = position.current_turn == shashki::Side::WHITE ? shashki::GameResult::BLACK_WIN : shashki::GameResult::WHITE_WIN;
+    }
 
-    std::chrono::duration before_benchmark = std::chrono::high_resolution_clock::now().time_since_epoch();
+    return game_record;
+}
 
-    for (const shashki::BitBoard& bit_board : test_bit_boards) {
-        shashki::generate_moves_for_side(bit_board, shashki::Side::WHITE);
+void benchmark_game_validation()
+{
+    std::cout << "Preparing for game-validation benchmark...\n";
+
+    std::mt19937_64 random_number_generator = std::mt19937_64(2021);
+    std::vector<shashki::GameRecord> game_records = std::vector<shashki::GameRecord>();
+    unsigned long long plies = 0;
+
+    while (game_records.size() < VALIDATION_GAMES) {
+        game_records.push_back(random_game_record(random_number_generator));
+        plies += game_records.back().moves.size();
     }
 
+    unsigned int thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+
+    std::cout << "Preparation for game-validation benchmark finished.\n";
+    std::cout << "Starting game-validation benchmark on " << thread_count << " threads...\n";
+
+    std::chrono::duration before_benchmark = std::chrono::high_resolution_clock::now().time_since_epoch();
+    std::vector<int> first_illegal_plies = shashki::validate_game_records(game_records, thread_count);
     std::chrono::duration after_benchmark = std::chrono::high_resolution_clock::now().time_since_epoch();
+
     std::chrono::duration benchmark_duration = after_benchmark - before_benchmark;
     unsigned long long millis = std::chrono::duration_cast<std::chrono::milliseconds>(benchmark_duration).count();
+    long illegal_games = std::count_if(first_illegal_plies.begin(), first_illegal_plies.end(), [](int ply) { return ply >= 0; });
 
-    std::cout << "Move-generation benchmark finished.\n";
-    std::cout << "Moves generated for " << MAX_BOARDS_MOVE_GENERATION << " boards.\n";
-    std::cout << "Move-generation benchmark took " << millis << " milliseconds.\n";
-    std::cout << "Moves calculated for " << (int) (MAX_BOARDS_MOVE_GENERATION / (millis / 1000.0)) << " board constellations per second.\n\n";
+    std::cout << "Game-validation benchmark finished.\n";
+    std::cout << "Validated " << VALIDATION_GAMES << " games with " << plies << " plies, " << illegal_games << " games with illegal plies.\n";
+    std::cout << "Game-validation benchmark took " << millis << " milliseconds.\n";
+    std::cout << "Validated " << plies * 1000 / std::max(millis, 1ULL) << " plies per second.\n\n";
+}
+
+const int OPENING_TREE_PLIES = 12;
+const int OPENING_TREE_QUERIES = 1000000;
+
+void benchmark_opening_explorer()
+{
+    std::cout << "Preparing for opening-explorer benchmark...\n";
+
+    std::mt19937_64 random_number_generator = std::mt19937_64(2021);
+    std::vector<shashki::GameRecord> game_records = std::vector<shashki::GameRecord>();
+    std::vector<shashki::GameRecord> new_game_records = std::vector<shashki::GameRecord>();
+
+    while (game_records.size() < VALIDATION_GAMES) {
+        game_records.push_back(random_game_record(random_number_generator));
+    }
+
+    while (new_game_records.size() < VALIDATION_GAMES / 10) {
+        new_game_records.push_back(random_game_record(random_number_generator));
+    }
+
+    // Query the positions the games went through, so that (almost) every query is a hit.
+    std::vector<shashki::Position> query_positions = std::vector<shashki::Position>();
+
+    while (query_positions.size() < OPENING_TREE_QUERIES) {
+        const shashki::GameRecord& game_record = game_records[random_number_generator() % game_records.size()];
+        shashki::Position position = game_record.start_position;
+        std::size_t plies = random_number_generator() % std::min(game_record.moves.size() + 1, (std::size_t) OPENING_TREE_PLIES);
+
+        for (std::size_t ply = 0; ply < plies; ply++) {
+            shashki::execute_packed_move(position, game_record.moves[ply]);
+        }
+
+        query_positions.push_back(position);
+    }
+
+    unsigned int thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+    std::string path = (std::filesystem::temp_directory_path() / "shashki-benchmark-opening-tree.bin").string();
+
+    std::cout << "Preparation for opening-explorer benchmark finished.\n";
+    std::cout << "Starting opening-explorer benchmark on " << thread_count << " threads...\n";
+
+    std::chrono::duration before_build = std::chrono::high_resolution_clock::now().time_since_epoch();
+    shashki::build_opening_tree(path, game_records, OPENING_TREE_PLIES, thread_count);
+    std::chrono::duration before_update = std::chrono::high_resolution_clock::now().time_since_epoch();
+    shashki::update_opening_tree(path, new_game_records, OPENING_TREE_PLIES, thread_count);
+    std::chrono::duration before_queries = std::chrono::high_resolution_clock::now().time_since_epoch();
+
+    shashki::OpeningTree opening_tree = shashki::OpeningTree(path);
+    unsigned long long hits = 0;
+
+    for (const shashki::Position& position : query_positions) {
+        std::optional<shashki::OpeningStatistics> statistics = opening_tree.find(position, 3);
+        hits += statistics.has_value() ? 1 : 0;
+    }
+
+    std::chrono::duration after_queries = std::chrono::high_resolution_clock::now().time_since_epoch();
+    std::filesystem::remove(path);
+
+    unsigned long long build_millis = std::chrono::duration_cast<std::chrono::milliseconds>(before_update - before_build).count();
+    unsigned long long update_millis = std::chrono::duration_cast<std::chrono::milliseconds>(before_queries - before_update).count();
+    unsigned long long query_nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(after_queries - before_queries).count();
+
+    std::cout << "Opening-explorer benchmark finished.\n";
+    std::cout << "Building the tree of " << game_records.size() << " games (" << OPENING_TREE_PLIES << " plies) took " << build_millis << " milliseconds.\n";
+    std::cout << "Updating the tree with " << new_game_records.size() << " games took " << update_millis << " milliseconds.\n";
+    std::cout << "The tree holds " << opening_tree.position_count() << " positions, " << hits << " of " << OPENING_TREE_QUERIES << " queries were hits.\n";
+    std::cout << "A query takes on average " << query_nanos / OPENING_TREE_QUERIES << " nanoseconds.\n\n";
+}
+
+const int ADJUDICATION_GAMES = 40;
+const int ADJUDICATION_DEPTH = 6;
+const int ADJUDICATION_OPENING_PLIES = 6;
+const int ADJUDICATION_MAX_PLIES = 400;
+
+void execute_move_path(shashki::Game& game, const shashki::Move& move)
+{
+    game.execute_move(move);
+
+    if (!move.get_follow_moves().empty()) {
+        execute_move_path(game, move.get_follow_moves().front());
+    }
+}
+
+/**
+ * Plays self-play games to their end by the rules and compares the early verdicts
+ * of an Adjudicator (by score and recogniser) with the played-out results.
+ */
+void benchmark_adjudication()
+{
+    std::cout << "Starting adjudication benchmark...\n";
+
+    shashki::AdjudicationConfig config = shashki::AdjudicationConfig();
+    shashki::AdjudicationConfig rules_config = shashki::AdjudicationConfig();
+    rules_config.score_plies = 0;
+    rules_config.use_recogniser = false;
+
+    int adjudicated_games = 0;
+    int disagreeing_games = 0;
+    unsigned long long played_plies = 0;
+    unsigned long long adjudicated_plies = 0;
+
+    for (int count = 0; count < ADJUDICATION_GAMES; count++) {
+        shashki::Game game = shashki::Game();
+        shashki::Adjudicator adjudicator = shashki::Adjudicator(config);
+        shashki::Adjudicator referee = shashki::Adjudicator(rules_config);
+        shashki::Adjudication early_adjudication = shashki::Adjudication{shashki::GameResult::UNKNOWN, shashki::AdjudicationReason::NONE};
+        shashki::GameResult played_result = shashki::GameResult::DRAW;
+        int early_ply = 0;
+        int ply = 0;
+
+        for (; ply < ADJUDICATION_MAX_PLIES; ply++) {
+            shashki::Position position = shashki::Position(game.get_bit_board(), game.get_current_turn());
+            // The adjudication takes the score in hundredths of a Man from the view of White.
+            int score = shashki::evaluate_position(position, -shashki::SEARCH_WIN_SCORE, shashki::SEARCH_WIN_SCORE);
+            score = position.current_turn == shashki::Side::WHITE ? score : -score;
+
+            if (early_adjudication.result == shashki::GameResult::UNKNOWN) {
+                early_adjudication = adjudicator.adjudicate(position, score);
+                early_ply = ply;
+            }
+
+            shashki::Adjudication adjudication = referee.adjudicate(position, score);
+
+            if (adjudication.result != shashki::GameResult::UNKNOWN) {
+                played_result = adjudication.result;
+                break;
+            }
+
+            execute_move_path(game, ply < ADJUDICATION_OPENING_PLIES ? shashki::random_move(game) : shashki::best_move(game, ADJUDICATION_DEPTH));
+        }
+
+        played_plies += ply;
+        adjudicated_plies += early_adjudication.result == shashki::GameResult::UNKNOWN ? ply : early_ply;
+
+        if (early_adjudication.reason == shashki::AdjudicationReason::SCORE || early_adjudication.reason == shashki::AdjudicationReason::RECOGNISER) {
+            adjudicated_games++;
+            disagreeing_games += early_adjudication.result != played_result ? 1 : 0;
+        }
+    }
+
+    std::cout << "Adjudication benchmark finished.\n";
+    std::cout << adjudicated_games << " of " << ADJUDICATION_GAMES << " games were adjudicated early by score or recogniser, "
+              << disagreeing_games << " of them disagree with the played-out result.\n";
+    std::cout << "Adjudication needs " << adjudicated_plies << " of " << played_plies << " played-out plies ("
+              << (played_plies - adjudicated_plies) * 100 / std::max(played_plies, 1ULL) << "% saved).\n\n";
+}
+
+/**
+ * Positions with White to move where flying Kings can jump scattered pieces
+ * in many different orders, so their capture trees are as big as they get.
+ */
+const shashki::BitBoard CAPTURE_STRESS_BIT_BOARDS[] = {
+    shashki::BitBoard(0x0ULL, 0x4580000000000180ULL, 0x2100200000000ULL, 0x400050025000ULL),
+    shashki::BitBoard(0x0ULL, 0x4000000000000100ULL, 0x2a000a50225000ULL, 0x0ULL),
+    shashki::BitBoard(0x0ULL, 0x4000000000000108ULL, 0x2a040a50225000ULL, 0x0ULL),
+    shashki::BitBoard(0x0ULL, 0x100000200000ULL, 0x2a000a50005400ULL, 0x0ULL),
+    shashki::BitBoard(0x0ULL, 0x80000ULL, 0xa040a50005400ULL, 0x0ULL),
+    shashki::BitBoard(0x0ULL, 0x102ULL, 0xa400a50225000ULL, 0x0ULL)};
+const int CAPTURE_STRESS_REPETITIONS = 10000;
+const int CAPTURE_STRESS_DEPTH = 8;
+
+/**
+ * Returns the average microseconds of a generation function on the position.
+ */
+template <typename Generation>
+double average_microseconds(Generation generation)
+{
+    std::chrono::duration before_benchmark = std::chrono::high_resolution_clock::now().time_since_epoch();
+
+    for (int count = 0; count < CAPTURE_STRESS_REPETITIONS; count++) {
+        generation();
+    }
+
+    std::chrono::duration after_benchmark = std::chrono::high_resolution_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(after_benchmark - before_benchmark).count() / 1000.0 / CAPTURE_STRESS_REPETITIONS;
+}
+
+void benchmark_capture_stress()
+{
+    std::cout << "Starting capture-stress benchmark...\n";
+
+    shashki::TranspositionTable table = shashki::TranspositionTable(1 << 20);
+    unsigned long long slowest_search = 0;
+
+    for (const shashki::BitBoard& bit_board : CAPTURE_STRESS_BIT_BOARDS) {
+        shashki::Position position = shashki::Position(bit_board, shashki::Side::WHITE);
+        std::vector<shashki::BitBoard> distinct_bit_boards = std::vector<shashki::BitBoard>();
+        std::vector<shashki::CaptureState> visited_states = std::vector<shashki::CaptureState>();
+        shashki::generate_distinct_bit_boards_for_position(position, distinct_bit_boards, visited_states);
+
+        double move_micros = average_microseconds([&]() { return shashki::generate_moves_for_side(position.bit_board, position.current_turn); });
+        double path_micros = average_microseconds([&]() { return shashki::generate_bit_boards_for_position(position); });
+        double distinct_micros = average_microseconds([&]() { shashki::generate_distinct_bit_boards_for_position(position, distinct_bit_boards, visited_states); });
+
+        table.clear();
+        std::chrono::duration before_search = std::chrono::high_resolution_clock::now().time_since_epoch();
+        shashki::search_position(position, CAPTURE_STRESS_DEPTH, table);
+        std::chrono::duration after_search = std::chrono::high_resolution_clock::now().time_since_epoch();
+        unsigned long long search_millis = std::chrono::duration_cast<std::chrono::milliseconds>(after_search - before_search).count();
+        slowest_search = std::max(slowest_search, search_millis);
+
+        std::cout << shashki::count_move_paths(position) << " move paths to " << distinct_bit_boards.size() << " distinct BitBoards: "
+                  << move_micros << " us as Move tree, " << path_micros << " us as paths, " << distinct_micros << " us as distinct BitBoards, "
+                  << search_millis << " ms for a search of depth " << CAPTURE_STRESS_DEPTH << ".\n";
+    }
+
+    std::cout << "Capture-stress benchmark finished.\n";
+    std::cout << "The slowest search took " << slowest_search << " milliseconds.\n\n";
 }
 
+const int BATCH_POSITIONS = 2000;
+const int BATCH_DEPTH = 6;
+const std::size_t BATCH_HASH_ENTRIES = 1 << 24;
+const std::size_t BATCH_INTERLEAVINGS[] = {1, 2, 4, 8, 16};
+
+/**
+ * Searches a batch of positions from random games with a large TranspositionTable,
+ * one after another and with several interleaved searches on the same single thread.
+ */
+void benchmark_batch_search()
+{
+    std::cout << "Preparing for batch-search benchmark...\n";
+
+    std::mt19937_64 random_number_generator = std::mt19937_64(2021);
+    std::vector<shashki::Position> positions = std::vector<shashki::Position>();
+
+    while (positions.size() < BATCH_POSITIONS) {
+        shashki::GameRecord game_record = random_game_record(random_number_generator);
+        shashki::Position position = game_record.start_position;
+
+        for (std::size_t ply = 0; ply < game_record.moves.size() && positions.size() < BATCH_POSITIONS; ply++) {
+            shashki::execute_packed_move(position, game_record.moves[ply]);
+
+            if (ply % 8 == 7) {
+                positions.push_back(position);
+            }
+        }
+    }
+
+    shashki::TranspositionTable table = shashki::TranspositionTable(BATCH_HASH_ENTRIES);
+
+    std::cout << "Preparation for batch-search benchmark finished.\n";
+    std::cout << "Starting batch-search benchmark with " << BATCH_POSITIONS << " positions at depth " << BATCH_DEPTH
+              << " and " << table.size() * sizeof(shashki::TranspositionEntry) / (1 << 20) << " MB of TranspositionTable on 1 thread...\n";
+
+    shashki::EvaluationStatistics statistics = shashki::EvaluationStatistics{0, 0, 0};
+
+    for (std::size_t interleaved_searches : BATCH_INTERLEAVINGS) {
+        table.clear();
+        statistics = shashki::EvaluationStatistics{0, 0, 0};
+
+        std::chrono::duration before_benchmark = std::chrono::high_resolution_clock::now().time_since_epoch();
+        std::vector<shashki::SearchResult> results = shashki::analyse_positions(positions, BATCH_DEPTH, table, interleaved_searches);
+        std::chrono::duration after_benchmark = std::chrono::high_resolution_clock::now().time_since_epoch();
+
+        std::chrono::duration benchmark_duration = after_benchmark - before_benchmark;
+        unsigned long long millis = std::chrono::duration_cast<std::chrono::milliseconds>(benchmark_duration).count();
+        unsigned long long nodes = 0;
+
+        for (const shashki::SearchResult& result : results) {
+            nodes += result.nodes;
+            statistics.evaluations += result.evaluation_statistics.evaluations;
+            statistics.material_exits += result.evaluation_statistics.material_exits;
+            statistics.structure_exits += result.evaluation_statistics.structure_exits;
+        }
+
+        std::cout << interleaved_searches << " interleaved searches took " << millis << " milliseconds for "
+                  << nodes << " nodes (" << nodes * 1000 / std::max(millis, 1ULL) << " nodes per second).\n";
+    }
+
+    unsigned long long skipped_evaluations = statistics.material_exits + statistics.structure_exits;
+
+    std::cout << "Batch-search benchmark finished.\n";
+    std::cout << "Of " << statistics.evaluations << " evaluations " << statistics.material_exits << " returned after the material tier and "
+              << statistics.structure_exits << " after the structure tier, the expensive tier was skipped in "
+              << skipped_evaluations * 100 / std::max(statistics.evaluations, 1ULL) << "% of them.\n\n";
+}
+
+const int TACTICAL_POSITIONS = 100;
+const int TACTICAL_DEPTH = 6;
+const int TACTICAL_REFERENCE_DEPTH = 10;
+
+/**
+ * Collects positions from random games where the side in turn cannot jump
+ * but the opponent threatens to jump some of its pieces.
+ */
+std::vector<shashki::Position> tactical_positions()
+{
+    std::mt19937_64 random_number_generator = std::mt19937_64(2021);
+    std::vector<shashki::Position> positions = std::vector<shashki::Position>();
+
+    while (positions.size() < TACTICAL_POSITIONS) {
+        shashki::GameRecord game_record = random_game_record(random_number_generator);
+        shashki::Position position = game_record.start_position;
+
+        for (std::size_t ply = 0; ply < game_record.moves.size(); ply++) {
+            shashki::execute_packed_move(position, game_record.moves[ply]);
+
+            if (ply >= 12 && shashki::calculate_threats(position.bit_board).of_side(position.current_turn).attacked_pieces != 0
+                && !shashki::side_can_capture(position.bit_board, position.current_turn)
+                && shashki::generate_bit_boards_for_position(position).size() > 1) {
+                positions.push_back(position);
+                break;
+            }
+        }
+    }
+
+    return positions;
+}
+
+/**
+ * Searches a suite of tactical positions with and without singular extensions
+ * and compares the best moves with the ones of a deeper search.
+ */
+void benchmark_singular_extensions()
+{
+    std::cout << "Preparing for singular-extension benchmark...\n";
+
+    std::vector<shashki::Position> positions = tactical_positions();
+    shashki::TranspositionTable table = shashki::TranspositionTable(1 << 22);
+    shashki::SearchConfig plain_config = shashki::SearchConfig();
+    shashki::SearchConfig singular_config = shashki::SearchConfig();
+    singular_config.singular_extensions = true;
+    std::vector<shashki::SearchResult> references = std::vector<shashki::SearchResult>();
+
+    for (const shashki::Position& position : positions) {
+        table.clear();
+        references.push_back(shashki::search_position(position, TACTICAL_REFERENCE_DEPTH, table, plain_config));
+    }
+
+    std::cout << "Preparation for singular-extension benchmark finished.\n";
+    std::cout << "Starting singular-extension benchmark with " << TACTICAL_POSITIONS << " tactical positions at depth " << TACTICAL_DEPTH
+              << " (compared with depth " << TACTICAL_REFERENCE_DEPTH << ")...\n";
+
+    for (const shashki::SearchConfig& config : {plain_config, singular_config}) {
+        unsigned long long nodes = 0;
+        unsigned long long extensions = 0;
+        int solved_positions = 0;
+
+        for (std::size_t index = 0; index < positions.size(); index++) {
+            table.clear();
+            shashki::SearchResult result = shashki::search_position(positions[index], TACTICAL_DEPTH, table, config);
+            nodes += result.nodes;
+            extensions += result.singular_extensions;
+            solved_positions += result.best_bit_board == references[index].best_bit_board ? 1 : 0;
+        }
+
+        std::cout << (config.singular_extensions ? "With" : "Without") << " singular extensions " << solved_positions << " of "
+                  << TACTICAL_POSITIONS << " best moves agree, " << nodes << " nodes were searched and " << extensions << " moves extended.\n";
+    }
+
+    std::cout << "Singular-extension benchmark finished.\n\n";
+}
+
+const std::size_t POSITION_SET_POSITIONS = 1 << 24;
+const int POSITION_SET_MAX_PLIES = 150;
+
+/**
+ * Inserts the positions into the set and looks every one of them up afterwards together
+ * with the same BitBoard and the other side to move (which is mostly a miss).
+ * Prints the timings with the given name and returns the number of hits.
+ */
+template<typename Set>
+unsigned long long benchmark_position_set(const std::string& name,
+                                          Set& set,
+                                          const std::vector<shashki::Position>& positions)
+{
+    std::chrono::duration before_inserts = std::chrono::high_resolution_clock::now().time_since_epoch();
+
+    for (const shashki::Position& position : positions) {
+        set.insert(position);
+    }
+
+    std::chrono::duration before_lookups = std::chrono::high_resolution_clock::now().time_since_epoch();
+    unsigned long long hits = 0;
+
+    for (const shashki::Position& position : positions) {
+        hits += set.count(position);
+        hits += set.count(shashki::Position(position.bit_board, shashki::side_opposite(position.current_turn)));
+    }
+
+    std::chrono::duration after_lookups = std::chrono::high_resolution_clock::now().time_since_epoch();
+
+    unsigned long long insert_millis = std::chrono::duration_cast<std::chrono::milliseconds>(before_lookups - before_inserts).count();
+    unsigned long long lookup_millis = std::chrono::duration_cast<std::chrono::milliseconds>(after_lookups - before_lookups).count();
+
+    std::cout << name << ": " << positions.size() << " insertions took " << insert_millis << " milliseconds ("
+              << insert_millis * 1000000 / positions.size() << " nanoseconds each), "
+              << positions.size() * 2 << " lookups took " << lookup_millis << " milliseconds ("
+              << lookup_millis * 1000000 / (positions.size() * 2) << " nanoseconds each).\n";
+
+    return hits;
+}
+
+/**
+ * A PositionSet with the interface of std::unordered_set used by "benchmark_position_set()".
+ */
+struct FlatPositionSet
+{
+    shashki::PositionSet    positions;
+
+    void insert(const shashki::Position& position)
+    {
+        this->positions.insert(position);
+    }
+
+    std::size_t count(const shashki::Position& position) const
+    {
+        return this->positions.contains(position) ? 1 : 0;
+    }
+};
+
+/**
+ * Collects all the positions of random games (including the repetitions between the games,
+ * like a dataset to deduplicate) and compares the PositionSet with std::unordered_set.
+ */
+void benchmark_position_sets()
+{
+    std::cout << "Preparing for position-set benchmark...\n";
+
+    std::mt19937_64 random_number_generator = std::mt19937_64(2021);
+    std::vector<shashki::Position> positions = std::vector<shashki::Position>();
+    std::vector<shashki::BitBoard> bit_boards = std::vector<shashki::BitBoard>();
+
+    positions.reserve(POSITION_SET_POSITIONS);
+
+    while (positions.size() < POSITION_SET_POSITIONS) {
+        shashki::Position position = shashki::Position();
+
+        for (int ply = 0; ply < POSITION_SET_MAX_PLIES && positions.size() < POSITION_SET_POSITIONS; ply++) {
+            positions.push_back(position);
+            shashki::generate_distinct_bit_boards_for_position(position, bit_boards);
+
+            if (bit_boards.empty()) {
+                break;
+            }
+
+            position = shashki::Position(bit_boards[random_number_generator() % bit_boards.size()],
+                                         shashki::side_opposite(position.current_turn));
+        }
+    }
+
+    std::cout << "Preparation for position-set benchmark finished.\n";
+    std::cout << "Starting position-set benchmark with " << positions.size() << " positions...\n";
+
+    FlatPositionSet flat_set = FlatPositionSet();
+    unsigned long long flat_hits = benchmark_position_set("PositionSet", flat_set, positions);
+    std::size_t flat_size = flat_set.positions.size();
+    std::size_t flat_megabytes = flat_set.positions.capacity() * (sizeof(shashki::PositionSlot<shashki::NoPositionValue>) + 1) / (1 << 20);
+    flat_set = FlatPositionSet();
+
+    std::unordered_set<shashki::Position> standard_set = std::unordered_set<shashki::Position>();
+    unsigned long long standard_hits = benchmark_position_set("std::unordered_set", standard_set, positions);
+    std::size_t standard_size = standard_set.size();
+
+    std::cout << "Position-set benchmark finished.\n";
+    std::cout << "Both sets hold " << flat_size << " and " << standard_size << " distinct positions with "
+              << flat_hits << " and " << standard_hits << " hits, the PositionSet takes " << flat_megabytes << " MB.\n\n";
+}
+
+
 void benchmark_engine_depth(int depth, int repititions)
 {
     std::cout << "Benchmark engine depth " << depth << "...\n";
@@ -78,6 +598,13 @@ int main()
 {
     std::cout << "- Shashki-Engine benchmark -\n\n";
     benchmark_move_generation();
+    benchmark_game_validation();
+    benchmark_opening_explorer();
+    benchmark_adjudication();
+    benchmark_capture_stress();
+    benchmark_batch_search();
+    benchmark_singular_extensions();
+    benchmark_position_sets();
     benchmark_engine();
     std::cout << "Benchmark finished!\n";
     return 0;
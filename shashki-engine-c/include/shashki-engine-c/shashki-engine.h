@@ -0,0 +1,182 @@
+/**
+ * Project: Shashki-Engine
+ * Library: shashki-engine-c
+ * Author:  Jean-Luc Düe
+ * Module:  shashki-engine
+ *
+ * This module includes the C interface of the engine for the usage
+ * from other languages (FFI). It only uses plain structures and fixed size
+ * integers, all the C++ types stay behind an opaque engine handle.
+ * The functions work on batches of positions and write into buffers
+ * owned by the caller, no function returns memory that has to be freed.
+ */
+
+#ifndef SHASHKI_ENGINE_C_H
+#define SHASHKI_ENGINE_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(SHASHKI_ENGINE_C_BUILD)
+#    define SHASHKI_API __declspec(dllexport)
+#  else
+#    define SHASHKI_API __declspec(dllimport)
+#  endif
+#else
+#  define SHASHKI_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The version of this interface. It is only increased
+ * if the layout of a structure or a function signature changes.
+ */
+#define SHASHKI_API_VERSION 1
+
+/**
+ * The status codes returned by the functions.
+ * SHASHKI_ERROR_BUFFER_TOO_SMALL means the caller has to retry with a bigger buffer,
+ * SHASHKI_ERROR_BUSY that an asynchronous analysis of the engine is still running.
+ */
+#define SHASHKI_OK                          0
+#define SHASHKI_ERROR_INVALID_ARGUMENT      -1
+#define SHASHKI_ERROR_BUFFER_TOO_SMALL      -2
+#define SHASHKI_ERROR_BUSY                  -3
+#define SHASHKI_ERROR_OUT_OF_MEMORY         -4
+#define SHASHKI_ERROR_INTERNAL              -5
+
+/**
+ * The sides (shashki_position.side).
+ */
+#define SHASHKI_WHITE   0
+#define SHASHKI_BLACK   1
+
+/**
+ * A position: the four 64-bit integers of the BitBoard (one bit per board position,
+ * bit 0 is H1 and bit 63 is A8) and the side to move. 40 bytes.
+ */
+typedef struct shashki_position
+{
+    uint64_t    white_men;
+    uint64_t    white_kings;
+    uint64_t    black_men;
+    uint64_t    black_kings;
+    uint32_t    side;
+    uint32_t    reserved;
+} shashki_position;
+
+/**
+ * A legal move: the source and target board position of the moving piece,
+ * the number of jumped pieces and the position after the move. 48 bytes.
+ */
+typedef struct shashki_move
+{
+    shashki_position    result;
+    uint8_t             source;
+    uint8_t             target;
+    uint8_t             captures;
+    uint8_t             reserved[5];
+} shashki_move;
+
+/**
+ * The analysis of one position: the position after the best move (the position
+ * itself if there is no move), the score in hundredths of a Man (positive means
+ * White has the advantage) and the number of searched nodes. 56 bytes.
+ */
+typedef struct shashki_analysis
+{
+    shashki_position    best_result;
+    int32_t             score;
+    uint32_t            reserved;
+    uint64_t            nodes;
+} shashki_analysis;
+
+/**
+ * The opaque engine handle. It owns the transposition table and the working memory
+ * of the engine. One handle must only be used by one thread at a time, but
+ * different handles can be used by different threads. Moves can be generated and
+ * positions be evaluated while an asynchronous analysis of the same handle is running.
+ */
+typedef struct shashki_engine shashki_engine;
+
+/**
+ * Returns SHASHKI_API_VERSION of the library, so that a caller
+ * can check whether it has been built against the same interface.
+ */
+SHASHKI_API int shashki_api_version(void);
+
+/**
+ * Writes the start position (White to move) into position.
+ */
+SHASHKI_API int shashki_start_position(shashki_position* position);
+
+/**
+ * Creates an engine with a transposition table of hash_entries entries (rounded down
+ * to a power of two, 16 bytes each) and writes its handle into engine.
+ * Returns SHASHKI_ERROR_INVALID_ARGUMENT for more than 2^32 entries (64 GB)
+ * and SHASHKI_ERROR_OUT_OF_MEMORY if the table cannot be allocated.
+ */
+SHASHKI_API int shashki_engine_create(size_t hash_entries,
+                                      shashki_engine** engine);
+
+/**
+ * Destroys the engine. A running asynchronous analysis is waited for first.
+ * Passing NULL does nothing.
+ */
+SHASHKI_API void shashki_engine_destroy(shashki_engine* engine);
+
+/**
+ * Generates the legal moves of count positions into the moves buffer of move_capacity moves.
+ * The moves of positions[i] are written to moves[move_offsets[i]] up to moves[move_offsets[i + 1]],
+ * so move_offsets needs room for count + 1 values. Move paths that end in the same position
+ * are only written once. If the buffer is too small, SHASHKI_ERROR_BUFFER_TOO_SMALL is returned
+ * and move_offsets[count] holds the needed capacity (the other offsets are undefined then).
+ */
+SHASHKI_API int shashki_generate_moves(shashki_engine* engine,
+                                       const shashki_position* positions,
+                                       size_t count,
+                                       shashki_move* moves,
+                                       size_t move_capacity,
+                                       size_t* move_offsets);
+
+/**
+ * Evaluates count positions statically (without searching) into scores,
+ * in hundredths of a Man and positive if White has the advantage.
+ */
+SHASHKI_API int shashki_evaluate_positions(shashki_engine* engine,
+                                           const shashki_position* positions,
+                                           size_t count,
+                                           int32_t* scores);
+
+/**
+ * Starts the analysis of count positions with the given search depth on a background thread
+ * and returns immediately. The results are written into analyses (count of them).
+ * Both buffers must stay valid and untouched until "shashki_analysis_wait()" has returned
+ * (or "shashki_analysis_done()" returned 1). Returns SHASHKI_ERROR_BUSY if an analysis is still running.
+ */
+SHASHKI_API int shashki_analyse_positions_async(shashki_engine* engine,
+                                                const shashki_position* positions,
+                                                size_t count,
+                                                int depth,
+                                                shashki_analysis* analyses);
+
+/**
+ * Returns 1 if no asynchronous analysis of the engine is running anymore, 0 otherwise.
+ */
+SHASHKI_API int shashki_analysis_done(const shashki_engine* engine);
+
+/**
+ * Waits for the asynchronous analysis of the engine and returns its status.
+ * Returns SHASHKI_OK if there is none.
+ */
+SHASHKI_API int shashki_analysis_wait(shashki_engine* engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
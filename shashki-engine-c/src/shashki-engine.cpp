@@ -0,0 +1,339 @@
+#include "shashki-engine-c/shashki-engine.h"
+
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "shashki-engine/evaluation.hpp"
+#include "shashki-engine/move-generation.hpp"
+#include "shashki-engine/search.hpp"
+#include "shashki-engine/validation.hpp"
+
+static_assert(sizeof(shashki_position) == 40, "The layout of shashki_position is part of the interface.");
+static_assert(sizeof(shashki_move) == 48, "The layout of shashki_move is part of the interface.");
+static_assert(sizeof(shashki_analysis) == 56, "The layout of shashki_analysis is part of the interface.");
+
+/**
+ * The bits of the dark squares, the only ones pieces can stand on.
+ */
+const unsigned long long DARK_SQUARES = 0x55AA55AA55AA55AAULL;
+
+/**
+ * The number of positions an asynchronous analysis searches at the same time
+ * (see "shashki::analyse_positions()").
+ */
+const std::size_t ANALYSIS_INTERLEAVED_SEARCHES = 4;
+
+/**
+ * The largest transposition table an engine can be created with (2^32 entries, 64 GB).
+ */
+const std::size_t MAX_HASH_ENTRIES = (std::size_t) 1 << 32;
+
+/**
+ * The engine behind the opaque handle. bit_boards, visited_states and attack_bit_boards are the
+ * reused working memory of the move generation (so that generating a batch does not allocate
+ * for every position), analysis_positions the copy of the positions of the running analysis.
+ * The analysis only touches table and analysis_positions, so moves can be generated and
+ * positions be evaluated while it is running.
+ */
+struct shashki_engine
+{
+    shashki::TranspositionTable         table;
+    std::vector<shashki::BitBoard>      bit_boards;
+    std::vector<shashki::CaptureState>  visited_states;
+    std::vector<shashki::BitBoard>      attack_bit_boards;
+    std::vector<shashki::Position>      analysis_positions;
+    std::thread                         analysis_thread;
+    std::atomic<bool>                   analysis_running;
+    int                                 analysis_status;
+
+    shashki_engine(std::size_t hash_entries)
+        : table(hash_entries),
+          bit_boards(std::vector<shashki::BitBoard>()),
+          visited_states(std::vector<shashki::CaptureState>()),
+          attack_bit_boards(std::vector<shashki::BitBoard>()),
+          analysis_positions(std::vector<shashki::Position>()),
+          analysis_thread(),
+          analysis_running(false),
+          analysis_status(SHASHKI_OK) {}
+};
+
+/**
+ * Converts the plain position into a Position. Returns false if the position
+ * is impossible (an unknown side, pieces on light squares or on the same square).
+ */
+bool convert_position(const shashki_position& plain_position,
+                      shashki::Position& position)
+{
+    if (plain_position.side != SHASHKI_WHITE && plain_position.side != SHASHKI_BLACK) {
+        return false;
+    }
+
+    unsigned long long boards[] = {plain_position.white_men, plain_position.white_kings,
+                                   plain_position.black_men, plain_position.black_kings};
+    unsigned long long occupied = 0;
+
+    for (unsigned long long board : boards) {
+        if ((board & ~DARK_SQUARES) != 0 || (board & occupied) != 0) {
+            return false;
+        }
+
+        occupied |= board;
+    }
+
+    position.bit_board = shashki::BitBoard(plain_position.white_men,
+                                           plain_position.white_kings,
+                                           plain_position.black_men,
+                                           plain_position.black_kings);
+    position.current_turn = plain_position.side == SHASHKI_WHITE ? shashki::Side::WHITE : shashki::Side::BLACK;
+
+    return true;
+}
+
+/**
+ * Converts the BitBoard and the side to move into a plain position.
+ */
+shashki_position convert_bit_board(const shashki::BitBoard& bit_board,
+                                   shashki::Side side)
+{
+    shashki_position plain_position = shashki_position();
+
+    plain_position.white_men = bit_board.white_men;
+    plain_position.white_kings = bit_board.white_kings;
+    plain_position.black_men = bit_board.black_men;
+    plain_position.black_kings = bit_board.black_kings;
+    plain_position.side = side == shashki::Side::WHITE ? SHASHKI_WHITE : SHASHKI_BLACK;
+
+    return plain_position;
+}
+
+/**
+ * Calls the function and translates the exceptions into status codes,
+ * since no exception may leave the C interface.
+ */
+template<typename Function>
+int call_guarded(Function&& function)
+{
+    try {
+        return function();
+    } catch (const std::invalid_argument&) {
+        return SHASHKI_ERROR_INVALID_ARGUMENT;
+    } catch (const std::bad_alloc&) {
+        return SHASHKI_ERROR_OUT_OF_MEMORY;
+    } catch (...) {
+        return SHASHKI_ERROR_INTERNAL;
+    }
+}
+
+int shashki_api_version(void)
+{
+    return SHASHKI_API_VERSION;
+}
+
+int shashki_start_position(shashki_position* position)
+{
+    if (position == NULL) {
+        return SHASHKI_ERROR_INVALID_ARGUMENT;
+    }
+
+    shashki::Position start_position = shashki::Position();
+    *position = convert_bit_board(start_position.bit_board, start_position.current_turn);
+
+    return SHASHKI_OK;
+}
+
+int shashki_engine_create(size_t hash_entries,
+                          shashki_engine** engine)
+{
+    if (engine == NULL) {
+        return SHASHKI_ERROR_INVALID_ARGUMENT;
+    }
+
+    *engine = NULL;
+
+    if (hash_entries > MAX_HASH_ENTRIES) {
+        return SHASHKI_ERROR_INVALID_ARGUMENT;
+    }
+
+    return call_guarded([&]() {
+        *engine = new shashki_engine(hash_entries);
+        return SHASHKI_OK;
+    });
+}
+
+void shashki_engine_destroy(shashki_engine* engine)
+{
+    if (engine == NULL) {
+        return;
+    }
+
+    shashki_analysis_wait(engine);
+    delete engine;
+}
+
+int shashki_generate_moves(shashki_engine* engine,
+                           const shashki_position* positions,
+                           size_t count,
+                           shashki_move* moves,
+                           size_t move_capacity,
+                           size_t* move_offsets)
+{
+    if (engine == NULL || move_offsets == NULL || (positions == NULL && count > 0) || (moves == NULL && move_capacity > 0)) {
+        return SHASHKI_ERROR_INVALID_ARGUMENT;
+    }
+
+    return call_guarded([&]() {
+        shashki::Position position = shashki::Position();
+        std::size_t move_count = 0;
+
+        for (std::size_t i = 0; i < count; i++) {
+            if (!convert_position(positions[i], position)) {
+                return SHASHKI_ERROR_INVALID_ARGUMENT;
+            }
+
+            move_offsets[i] = move_count;
+            shashki::generate_distinct_bit_boards_for_position(position, engine->bit_boards, engine->visited_states);
+            shashki::Side next_turn = shashki::side_opposite(position.current_turn);
+
+            for (const shashki::BitBoard& bit_board : engine->bit_boards) {
+                if (move_count < move_capacity) {
+                    shashki::PackedMove packed_move = shashki::packed_move_between(position, bit_board, engine->attack_bit_boards);
+                    shashki_move& move = moves[move_count];
+
+                    move = shashki_move();
+                    move.result = convert_bit_board(bit_board, next_turn);
+                    move.source = (uint8_t) packed_move.source_position();
+                    move.target = (uint8_t) packed_move.target_position();
+                    move.captures = (uint8_t) __builtin_popcountll(packed_move.captures);
+                }
+
+                move_count++;
+            }
+        }
+
+        move_offsets[count] = move_count;
+
+        return move_count > move_capacity ? SHASHKI_ERROR_BUFFER_TOO_SMALL : SHASHKI_OK;
+    });
+}
+
+int shashki_evaluate_positions(shashki_engine* engine,
+                               const shashki_position* positions,
+                               size_t count,
+                               int32_t* scores)
+{
+    if (engine == NULL || ((positions == NULL || scores == NULL) && count > 0)) {
+        return SHASHKI_ERROR_INVALID_ARGUMENT;
+    }
+
+    return call_guarded([&]() {
+        shashki::Position position = shashki::Position();
+
+        for (std::size_t i = 0; i < count; i++) {
+            if (!convert_position(positions[i], position)) {
+                return SHASHKI_ERROR_INVALID_ARGUMENT;
+            }
+
+            // With the full window the evaluation is exact, it is turned to the view of White.
+            int score = shashki::evaluate_position(position, -shashki::SEARCH_WIN_SCORE, shashki::SEARCH_WIN_SCORE);
+            scores[i] = position.current_turn == shashki::Side::WHITE ? score : -score;
+        }
+
+        return SHASHKI_OK;
+    });
+}
+
+int shashki_analyse_positions_async(shashki_engine* engine,
+                                    const shashki_position* positions,
+                                    size_t count,
+                                    int depth,
+                                    shashki_analysis* analyses)
+{
+    if (engine == NULL || ((positions == NULL || analyses == NULL) && count > 0)
+        || depth < 0 || depth > shashki::MAX_SEARCH_DEPTH) {
+        return SHASHKI_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (engine->analysis_running.load(std::memory_order_acquire)) {
+        return SHASHKI_ERROR_BUSY;
+    }
+
+    // A finished analysis, whose outcome has not been waited for, is cleaned up first.
+    if (engine->analysis_thread.joinable()) {
+        engine->analysis_thread.join();
+    }
+
+    return call_guarded([&]() {
+        shashki::Position position = shashki::Position();
+        engine->analysis_positions.clear();
+
+        for (std::size_t i = 0; i < count; i++) {
+            if (!convert_position(positions[i], position)) {
+                return SHASHKI_ERROR_INVALID_ARGUMENT;
+            }
+
+            engine->analysis_positions.push_back(position);
+        }
+
+        engine->analysis_status = SHASHKI_OK;
+        engine->analysis_running.store(true, std::memory_order_release);
+
+        try {
+            engine->analysis_thread = std::thread([engine, depth, analyses]() {
+                engine->analysis_status = call_guarded([&]() {
+                    std::vector<shashki::SearchResult> results = shashki::analyse_positions(engine->analysis_positions,
+                                                                                            depth,
+                                                                                            engine->table,
+                                                                                            ANALYSIS_INTERLEAVED_SEARCHES);
+
+                    for (std::size_t i = 0; i < results.size(); i++) {
+                        shashki_analysis& analysis = analyses[i];
+                        shashki::Side next_turn = shashki::side_opposite(engine->analysis_positions[i].current_turn);
+
+                        // Without any move the best BitBoard is the position itself and the side to move stays.
+                        if (results[i].best_bit_board == engine->analysis_positions[i].bit_board) {
+                            next_turn = engine->analysis_positions[i].current_turn;
+                        }
+
+                        analysis = shashki_analysis();
+                        analysis.best_result = convert_bit_board(results[i].best_bit_board, next_turn);
+                        analysis.score = results[i].score;
+                        analysis.nodes = results[i].nodes;
+                    }
+
+                    return SHASHKI_OK;
+                });
+
+                engine->analysis_running.store(false, std::memory_order_release);
+            });
+        } catch (...) {
+            engine->analysis_running.store(false, std::memory_order_release);
+            throw;
+        }
+
+        return SHASHKI_OK;
+    });
+}
+
+int shashki_analysis_done(const shashki_engine* engine)
+{
+    if (engine == NULL) {
+        return 1;
+    }
+
+    return engine->analysis_running.load(std::memory_order_acquire) ? 0 : 1;
+}
+
+int shashki_analysis_wait(shashki_engine* engine)
+{
+    if (engine == NULL) {
+        return SHASHKI_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (engine->analysis_thread.joinable()) {
+        engine->analysis_thread.join();
+    }
+
+    return engine->analysis_status;
+}
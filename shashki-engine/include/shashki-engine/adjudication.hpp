@@ -0,0 +1,118 @@
+/**
+ * Project: Shashki-Engine
+ * Library: shashki-engine
+ * Author:  Jean-Luc Düe
+ * Module:  adjudication
+ *
+ * This module includes functionality for ending decided games early,
+ * as it is useful for self-play and engine matches.
+ */
+
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "shashki-engine/common.hpp"
+#include "shashki-engine/validation.hpp"
+
+namespace shashki
+{
+
+/**
+ * The reason why a game has been adjudicated.
+ * NO_MOVES is the regular end of a game (the side in turn cannot move and lost).
+ * RECOGNISER is a verdict of the verdict_probe (e.g. a bitbase) or the built-in recogniser.
+ * SCORE means the score stayed beyond the threshold for long enough.
+ * REPETITION and KING_MOVES are draws by the rules of Shashki.
+ */
+enum class AdjudicationReason
+{
+    NONE,
+    NO_MOVES,
+    RECOGNISER,
+    SCORE,
+    REPETITION,
+    KING_MOVES
+};
+
+/**
+ * An Adjudication is the verdict for a game together with its reason.
+ * The result is UNKNOWN (and the reason NONE) as long as the game shall go on.
+ */
+struct Adjudication
+{
+    GameResult          result;
+    AdjudicationReason  reason;
+};
+
+/**
+ * The AdjudicationConfig holds the thresholds of an Adjudicator.
+ * score_threshold is the (absolute) score in hundredths of a Man (the scale of "evaluate_position()"
+ * and SearchResult::score, not of "evaluate_bit_board()") from which on a game counts as decided
+ * and score_plies the number of consecutive plies the score has to stay beyond it.
+ * repetitions is the number of occurrences of the same position that is a draw.
+ * king_move_plies is the number of plies without any capture and without any Man move that is a draw.
+ * Setting score_plies, repetitions or king_move_plies to 0 disables that kind of adjudication.
+ * use_recogniser enables the built-in recogniser (see "recognise_position()").
+ * verdict_probe is an optional function (e.g. a bitbase lookup) that is asked before
+ * the recogniser and returns UNKNOWN if it has no verdict for the position.
+ */
+struct AdjudicationConfig
+{
+    int                                             score_threshold;
+    int                                             score_plies;
+    int                                             repetitions;
+    int                                             king_move_plies;
+    bool                                            use_recogniser;
+    std::function<GameResult(const Position&)>      verdict_probe;
+
+    /**
+     * Constructs the default configuration: a score of 400 (four Men ahead)
+     * for 12 plies, threefold repetition, the 15 move (30 plies)
+     * rule for Kings and the built-in recogniser.
+     */
+    AdjudicationConfig();
+};
+
+/**
+ * Returns a verdict for positions whose outcome is known without searching
+ * or UNKNOWN if there is none:
+ * A side without any pieces has lost. With Kings only on the board a single King
+ * against one or two Kings is a draw and a single King holding the main diagonal
+ * (A1-H8) against three Kings is a draw as well, as long as no piece can be jumped right now.
+ */
+GameResult recognise_position(const Position& position);
+
+/**
+ * An Adjudicator follows one game ply by ply and decides
+ * when the game can be ended early.
+ */
+class Adjudicator
+{
+    private:
+
+    AdjudicationConfig      config;
+    std::vector<Position>   reversible_positions;
+    int                     white_score_plies;
+    int                     black_score_plies;
+
+    public:
+
+    /**
+     * Constructs an Adjudicator for a new game with the given configuration.
+     * Throws std::invalid_argument if the configuration is invalid
+     * (negative values, a repetitions value of 1 or a score_threshold below 1
+     * while the score adjudication is enabled).
+     */
+    Adjudicator(const AdjudicationConfig& config);
+
+    /**
+     * Adds the next position of the game (including the start position) together
+     * with its score in hundredths of a Man (positive means White has the advantage,
+     * like SearchResult::score) and returns the Adjudication for the game so far.
+     */
+    Adjudication adjudicate(const Position& position,
+                            int score);
+};
+
+}
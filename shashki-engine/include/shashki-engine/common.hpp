@@ -174,6 +174,37 @@ struct BitBoard
     PieceType piece_type_on_position(int position) const;
 };
 
+/**
+ * A Position is a BitBoard constellation together with the Side
+ * that has the turn. Unlike a Game it holds no history of executed moves
+ * and knows nothing about combo situations, so it is the cheap value type to use
+ * whenever only the constellation and the side to move matter (e.g. perft or batch processing).
+ */
+struct Position
+{
+    BitBoard    bit_board;
+    Side        current_turn;
+
+    /**
+     * Constructs a Position with the start constellation in Shashki
+     * and White to move.
+     */
+    Position();
+
+    /**
+     * Constructs a Position with the given BitBoard and the Side to move.
+     */
+    Position(BitBoard bit_board,
+             Side current_turn);
+
+    /**
+     * Compares a Position to another Position.
+     * The BitBoard and the side to move must be identic
+     * in order to return true for this comparison.
+     */
+    bool operator == (const Position& position) const;
+};
+
 /**
  * Move is the representation of a move in Shashki possibly containing
  * several moves to follow in situations where multiple pieces can be jumped.
@@ -284,6 +315,8 @@ class Move
  * The color of the player with the current turn is stored in current_turn.
  * All the moves that has been executed on the game to result into the current bit_board
  * are stored in executed_moves.
+ * The Zobrist hash of the current situation (bit_board and current_turn) is stored in zobrist_key,
+ * it is updated incrementally whenever a move is executed or undone (see "zobrist_hash()").
  */
 class Game
 {
@@ -292,6 +325,7 @@ class Game
     BitBoard            bit_board;
     Side                current_turn;
     std::vector<Move>   executed_moves;
+    unsigned long long  zobrist_key;
 
     public:
 
@@ -364,6 +398,7 @@ class Game
     const BitBoard& get_bit_board() const;
     const Side& get_current_turn() const;
     const std::vector<Move>& get_executed_moves() const;
+    const unsigned long long& get_zobrist_key() const;
 };
 
 }
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include "shashki-engine/common.hpp"
 
 namespace shashki
@@ -25,4 +26,33 @@ namespace shashki
  */
 int evaluate_bit_board(const BitBoard& bit_board);
 
+/**
+ * The EvaluationStatistics count how often "evaluate_position()" has been called
+ * and how often it returned early: after the material tier (skipping the structure and
+ * the expensive tier) and after the structure tier (skipping only the expensive tier).
+ */
+struct EvaluationStatistics
+{
+    unsigned long long  evaluations;
+    unsigned long long  material_exits;
+    unsigned long long  structure_exits;
+};
+
+/**
+ * Evaluates the given Position from the view of the side in turn in hundredths of a Man
+ * (a Man is worth 100). The evaluation is split into three tiers from cheap to expensive:
+ * 1. Material and piece-square bonuses (advancement and centre of Men, the main diagonal for Kings).
+ * 2. Structure: Men that cannot be jumped from the front and Men guarding the own back row.
+ * 3. Mobility and threats (see "calculate_threats()").
+ * Every tier after the first one is limited to a margin, so as soon as the estimate so far
+ * plus the margins of the missing tiers is outside of (alpha, beta), the result is already
+ * known to be outside of the window and it is returned without the missing tiers (lazy evaluation).
+ * In this case the returned value is a bound (at most alpha or at least beta) and not the exact evaluation.
+ * If statistics is not NULL, the call is counted in it.
+ */
+int evaluate_position(const Position& position,
+                      int alpha,
+                      int beta,
+                      EvaluationStatistics* statistics = NULL);
+
 }
@@ -45,4 +45,105 @@ std::vector<Move> generate_moves_for_piece(const BitBoard& bit_board,
                                            const Piece& piece,
                                            unsigned long long capture_bit_board);
 
+/**
+ * Generates the resulting BitBoards of all the legal move paths for the given Position.
+ * It follows exactly the same rules as "generate_moves_for_side()" but does not build
+ * Move objects with their follow_moves. Every complete move path (a single move or
+ * a whole combo of jumps) results into one BitBoard. The order of the BitBoards is unspecified.
+ * This is the fast generator to use when only the reachable constellations matter
+ * (e.g. perft or the engine tree). It shall not be used in a combo situation.
+ */
+std::vector<BitBoard> generate_bit_boards_for_position(const Position& position);
+
+/**
+ * Same as "generate_bit_boards_for_position()" but writes the BitBoards into the given
+ * list (which is cleared first) instead of a new one, so that its memory can be reused
+ * from node to node (e.g. by the search).
+ */
+void generate_bit_boards_for_position(const Position& position,
+                                      std::vector<BitBoard>& bit_boards);
+
+/**
+ * Generates the resulting BitBoards of all the legal moves for the given Position into the given
+ * list (which is cleared first) like "generate_bit_boards_for_position()", but every BitBoard only once.
+ * Different jump paths often end in the same constellation (e.g. a King jumping the same pieces
+ * in another order); they are cut off as soon as they reach an already visited situation,
+ * so even positions with millions of paths only take as long as their distinct situations.
+ * This is the generator to use where only the constellations matter (e.g. the search),
+ * not where every move path counts (e.g. perft). The visited situations are kept in a new list
+ * for every call, hot loops shall use the overload below with lists they reuse.
+ */
+void generate_distinct_bit_boards_for_position(const Position& position,
+                                               std::vector<BitBoard>& bit_boards);
+
+/**
+ * A CaptureState is a visited situation of an attack path: the jumped pieces
+ * and the position of the piece (plus 64 if it is a King).
+ */
+struct CaptureState
+{
+    unsigned long long  capture_bit_board;
+    int                 piece;
+};
+
+/**
+ * Same as "generate_distinct_bit_boards_for_position()" but keeps the visited CaptureStates
+ * in the given list (which is cleared for every piece) instead of a new one. Passing the same
+ * lists from call to call (e.g. from node to node of the search) generates without any allocation
+ * once they have grown to the largest position seen so far.
+ */
+void generate_distinct_bit_boards_for_position(const Position& position,
+                                               std::vector<BitBoard>& bit_boards,
+                                               std::vector<CaptureState>& visited_states);
+
+/**
+ * Returns the number of legal move paths for the given Position, which is the number of BitBoards
+ * "generate_bit_boards_for_position()" would generate, without storing any of them.
+ * The jump paths are walked on a fixed size stack (one frame per jump of the current path),
+ * so the memory does not depend on the number of paths.
+ */
+unsigned long long count_move_paths(const Position& position);
+
+/**
+ * Generates the resulting BitBoards of all the attack paths of only one piece
+ * for the given BitBoard. It is the same as "generate_bit_boards_for_position()"
+ * restricted to jumps of this single piece (no combo situation is considered).
+ * The list is empty if the piece cannot jump at all.
+ */
+std::vector<BitBoard> generate_attack_bit_boards_for_piece(const BitBoard& bit_board,
+                                                           const Piece& piece);
+
+/**
+ * Same as "generate_attack_bit_boards_for_piece()" but writes the BitBoards into the given
+ * list (which is cleared first) instead of a new one, so that its memory can be reused.
+ */
+void generate_attack_bit_boards_for_piece(const BitBoard& bit_board,
+                                          const Piece& piece,
+                                          std::vector<BitBoard>& bit_boards);
+
+/**
+ * Generates the resulting BitBoards of all the normal (non-jumping) moves of only one piece
+ * for the given BitBoard. It does not check whether a jump is possible instead,
+ * which would make the normal moves illegal (see "side_can_capture()").
+ */
+std::vector<BitBoard> generate_normal_bit_boards_for_piece(const BitBoard& bit_board,
+                                                           const Piece& piece);
+
+/**
+ * Same as "generate_normal_bit_boards_for_piece()" but writes the BitBoards into the given
+ * list (which is cleared first) instead of a new one, so that its memory can be reused.
+ */
+void generate_normal_bit_boards_for_piece(const BitBoard& bit_board,
+                                          const Piece& piece,
+                                          std::vector<BitBoard>& bit_boards);
+
+/**
+ * Returns true if any piece of the given side can jump an opponents piece
+ * in the given BitBoard. As jumping is obligatory in Shashki this also tells
+ * whether normal moves are allowed at all. It is calculated for all pieces
+ * at once with bit-operations and does not generate any moves.
+ */
+bool side_can_capture(const BitBoard& bit_board,
+                      const Side& side);
+
 }
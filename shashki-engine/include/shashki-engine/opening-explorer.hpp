@@ -0,0 +1,117 @@
+/**
+ * Project: Shashki-Engine
+ * Library: shashki-engine
+ * Author:  Jean-Luc Düe
+ * Module:  opening-explorer
+ *
+ * This module includes functionality for aggregating statistics of
+ * game archives per position and for querying them from a memory-mapped file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+#include "shashki-engine/common.hpp"
+#include "shashki-engine/validation.hpp"
+
+namespace shashki
+{
+
+/**
+ * An OpeningContinuation is a move that has been played from a position
+ * together with the number of games it has been played in.
+ */
+struct OpeningContinuation
+{
+    PackedMove      move;
+    unsigned int    games;
+};
+
+/**
+ * The OpeningStatistics hold the aggregates of one position:
+ * the number of games the position occurred in, how many of those
+ * were won by White, drawn or won by Black (games with an UNKNOWN result
+ * only count in games) and the continuations, most common first.
+ */
+struct OpeningStatistics
+{
+    unsigned int                        games;
+    unsigned int                        white_wins;
+    unsigned int                        draws;
+    unsigned int                        black_wins;
+    std::vector<OpeningContinuation>    continuations;
+};
+
+/**
+ * Builds the opening tree file at the given path from the GameRecords.
+ * Every position of the first max_plies plies of every game is aggregated
+ * (by its Zobrist hash) with a parallel map-reduce over the games on thread_count threads.
+ * The position reached after the last aggregated ply counts as well, without a continuation.
+ * A game is only aggregated up to its first illegal ply.
+ * The max_plies are stored in the file, so that later updates can be checked against them.
+ * An existing file at the path is replaced. Throws std::runtime_error if the file cannot be written.
+ */
+void build_opening_tree(const std::string& path,
+                        const std::vector<GameRecord>& game_records,
+                        int max_plies,
+                        unsigned int thread_count);
+
+/**
+ * Adds the aggregates of new GameRecords to the opening tree file at the given path.
+ * The result is the same as building the file from all the games at once.
+ * If there is no file at the path yet, it is built from the new GameRecords only.
+ * The file is replaced atomically, so OpeningTrees opened before keep their old view.
+ * Throws std::runtime_error if the file cannot be read or written
+ * or if it has been built with another max_plies.
+ */
+void update_opening_tree(const std::string& path,
+                         const std::vector<GameRecord>& game_records,
+                         int max_plies,
+                         unsigned int thread_count);
+
+/**
+ * An OpeningTree is a read-only view onto an opening tree file.
+ * The file is memory-mapped and holds the positions sorted by their Zobrist hash,
+ * so a query is a binary search without any parsing or copying of the file.
+ */
+class OpeningTree
+{
+    private:
+
+    const unsigned char*    data;
+    std::size_t             size;
+
+    public:
+
+    /**
+     * Memory-maps the opening tree file at the given path.
+     * Throws std::runtime_error if the file cannot be opened or is no opening tree file
+     * or a corrupt one (an entry refers to continuations beyond the end of the file).
+     */
+    OpeningTree(const std::string& path);
+
+    /**
+     * Unmaps the opening tree file.
+     */
+    ~OpeningTree();
+
+    OpeningTree(const OpeningTree& opening_tree) = delete;
+    OpeningTree& operator = (const OpeningTree& opening_tree) = delete;
+
+    /**
+     * Returns the OpeningStatistics of the given position with at most
+     * max_continuations continuations or nothing if the position is not in the tree.
+     */
+    std::optional<OpeningStatistics> find(const Position& position,
+                                          std::size_t max_continuations) const;
+
+    /**
+     * Returns the number of positions in the tree.
+     */
+    std::size_t position_count() const;
+};
+
+}
@@ -0,0 +1,56 @@
+/**
+ * Project: Shashki-Engine
+ * Library: shashki-engine
+ * Author:  Jean-Luc Düe
+ * Module:  perft
+ *
+ * This module includes functionality for counting the leaf nodes
+ * of the move tree (perft) to verify and benchmark the move generation.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include "shashki-engine/common.hpp"
+
+namespace shashki
+{
+
+/**
+ * The PerftResult holds the outcome of a perft run.
+ * nodes is the number of leaf nodes counted at the given depth.
+ * milliseconds is the time the run took and nodes_per_second
+ * the resulting move-generation throughput.
+ */
+struct PerftResult
+{
+    unsigned long long  nodes;
+    unsigned long long  milliseconds;
+    unsigned long long  nodes_per_second;
+};
+
+/**
+ * Counts the leaf nodes of the move tree of the given position
+ * up to the given depth. Every complete move path (a single move
+ * or a whole combo of jumps) counts as one ply, just like the engine
+ * tree treats it. Every Move is built with all its follow_moves,
+ * nothing is cached and it runs on the calling thread only,
+ * so this is the reference to verify "fast_perft()" against.
+ */
+unsigned long long perft(const Position& position, int depth);
+
+/**
+ * Counts the same leaf nodes as "perft()" but optimised for throughput:
+ * - The leaves at the last ply are only counted (see "count_move_paths()"),
+ *   they are neither stored nor made (bulk counting).
+ * - Subtree counts are cached in a hash table keyed by position and depth.
+ *   hash_entries is the number of entries of that table (rounded down to
+ *   a power of two), 0 disables the hash table.
+ * - The moves of the root are split across thread_count threads.
+ */
+PerftResult fast_perft(const Position& position,
+                       int depth,
+                       unsigned int thread_count,
+                       std::size_t hash_entries);
+
+}
@@ -0,0 +1,472 @@
+/**
+ * Project: Shashki-Engine
+ * Library: shashki-engine
+ * Author:  Jean-Luc Düe
+ * Module:  position-set
+ *
+ * This module includes flat hash containers for positions (a set and a map),
+ * as they are needed for deduplicating datasets, repetition checks and importing games.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "shashki-engine/common.hpp"
+#include "shashki-engine/zobrist.hpp"
+
+namespace shashki
+{
+
+/**
+ * The control bytes of the slots of a PositionMap: a slot is either empty, deleted
+ * (it held a position that has been erased) or full, in which case its control byte
+ * holds the lower 7 bits of the Zobrist hash of its position (0 to 127).
+ */
+const signed char POSITION_SLOT_EMPTY = -128;
+const signed char POSITION_SLOT_DELETED = -2;
+
+/**
+ * A PositionGroup holds the control bytes of 16 neighbouring slots.
+ * All of them are compared at once, with SSE2 if the processor supports it
+ * and byte by byte otherwise.
+ */
+struct alignas(16) PositionGroup
+{
+    signed char controls[16];
+
+    /**
+     * Returns a bit mask of the slots with the given control byte (bit 0 is the first slot).
+     */
+    unsigned int match(signed char control) const;
+
+    /**
+     * Returns a bit mask of the slots that are empty or deleted.
+     */
+    unsigned int match_free() const;
+};
+
+/**
+ * A PositionSlot holds one position of a PositionMap together with its value.
+ * The BitBoard is stored as plain integers, so that allocating
+ * millions of slots does not construct millions of start constellations.
+ */
+template<typename Value>
+struct PositionSlot
+{
+    unsigned long long  white_men;
+    unsigned long long  white_kings;
+    unsigned long long  black_men;
+    unsigned long long  black_kings;
+    Side                current_turn;
+    Value               value;
+};
+
+/**
+ * A PositionMap maps Positions to values. It is a flat hash table with open addressing:
+ * all the slots are stored in one array and the position of a slot is found from
+ * its Zobrist hash. The upper bits of the hash select a group of 16 slots, the lower 7 bits are
+ * stored in the control byte of the slot, so one comparison of a PositionGroup finds all
+ * candidate slots of a group and the positions themselves are only compared for those.
+ * If a group is full, the next groups are probed (1, 2, 3, ... groups further on).
+ * The table grows to twice its size as soon as 7/8 of the slots are used.
+ * Unlike std::unordered_map it needs no allocation per position and the probing stays within
+ * one or two cache lines of control bytes. Value must be default constructible.
+ */
+template<typename Value>
+class PositionMap
+{
+    private:
+
+    std::unique_ptr<PositionGroup[]>        groups;
+    std::unique_ptr<PositionSlot<Value>[]>  slots;
+    std::size_t                             group_mask;
+    std::size_t                             full_slots;
+    std::size_t                             deleted_slots;
+
+    /**
+     * Returns the index of the slot holding the position or the number of slots if there is none.
+     */
+    std::size_t find_slot(const Position& position,
+                          unsigned long long hash) const;
+
+    /**
+     * Returns the index of the first empty or deleted slot for the hash.
+     */
+    std::size_t find_free_slot(unsigned long long hash) const;
+
+    /**
+     * Moves all the positions into a new table with the given number of groups
+     * (a power of two), which also removes the deleted slots.
+     */
+    void rehash(std::size_t group_count);
+
+    public:
+
+    /**
+     * Constructs an empty map with room for expected_size positions before it has to grow.
+     */
+    PositionMap(std::size_t expected_size = 0);
+
+    /**
+     * Inserts the position with the given value. Returns false and leaves
+     * the map as it is if the position is already in it.
+     */
+    bool insert(const Position& position,
+                const Value& value = Value());
+
+    /**
+     * Returns the value of the position, which is inserted with a default value if it is not in the map.
+     */
+    Value& operator [] (const Position& position);
+
+    /**
+     * Returns a pointer to the value of the position or NULL if the position is not in the map.
+     * The pointer is only valid until the next insertion.
+     */
+    Value* find(const Position& position);
+    const Value* find(const Position& position) const;
+
+    /**
+     * Returns true if the position is in the map.
+     */
+    bool contains(const Position& position) const;
+
+    /**
+     * Removes the position from the map. Returns false if it was not in the map.
+     */
+    bool erase(const Position& position);
+
+    /**
+     * Grows the table (if needed) so that size positions fit in without growing again.
+     */
+    void reserve(std::size_t size);
+
+    /**
+     * Removes all the positions but keeps the size of the table.
+     */
+    void clear();
+
+    /**
+     * Returns the number of positions in the map.
+     */
+    std::size_t size() const;
+
+    /**
+     * Returns the number of slots of the table.
+     */
+    std::size_t capacity() const;
+
+    /**
+     * Calls the function with every position and its value (in no particular order).
+     */
+    template<typename Function>
+    void for_each(Function&& function) const;
+};
+
+/**
+ * The value type of a PositionSet, which has no values.
+ */
+struct NoPositionValue {};
+
+/**
+ * A PositionSet is a set of Positions (see PositionMap).
+ */
+using PositionSet = PositionMap<NoPositionValue>;
+
+}
+
+inline unsigned int shashki::PositionGroup::match(signed char control) const
+{
+#if defined(__SSE2__)
+    __m128i group_controls = _mm_load_si128(reinterpret_cast<const __m128i*>(this->controls));
+
+    return (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(group_controls, _mm_set1_epi8(control)));
+#else
+    unsigned int mask = 0;
+
+    for (int i = 0; i < 16; i++) {
+        mask = mask | ((unsigned int) (this->controls[i] == control) << i);
+    }
+
+    return mask;
+#endif
+}
+
+inline unsigned int shashki::PositionGroup::match_free() const
+{
+    // Empty and deleted slots are the only ones with a negative control byte (the sign bit set).
+#if defined(__SSE2__)
+    return (unsigned int) _mm_movemask_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(this->controls)));
+#else
+    unsigned int mask = 0;
+
+    for (int i = 0; i < 16; i++) {
+        mask = mask | ((unsigned int) (this->controls[i] < 0) << i);
+    }
+
+    return mask;
+#endif
+}
+
+template<typename Value>
+shashki::PositionMap<Value>::PositionMap(std::size_t expected_size)
+    : groups(),
+      slots(),
+      group_mask(0),
+      full_slots(0),
+      deleted_slots(0)
+{
+    this->rehash(1);
+    this->reserve(expected_size);
+}
+
+template<typename Value>
+std::size_t shashki::PositionMap<Value>::find_slot(const Position& position,
+                                                   unsigned long long hash) const
+{
+    signed char control = (signed char) (hash & 0x7F);
+    std::size_t group_index = (hash >> 7) & this->group_mask;
+
+    // All the groups are probed at most once, since deleted slots can leave no group with an empty slot.
+    for (std::size_t step = 1; step <= this->group_mask + 1; step++) {
+        const PositionGroup& group = this->groups[group_index];
+
+        for (unsigned int mask = group.match(control); mask != 0; mask = mask & (mask - 1)) {
+            std::size_t slot_index = group_index * 16 + __builtin_ctz(mask);
+            const PositionSlot<Value>& slot = this->slots[slot_index];
+
+            if (slot.white_men == position.bit_board.white_men
+                && slot.white_kings == position.bit_board.white_kings
+                && slot.black_men == position.bit_board.black_men
+                && slot.black_kings == position.bit_board.black_kings
+                && slot.current_turn == position.current_turn) {
+                return slot_index;
+            }
+        }
+
+        // A position is always inserted into the first group with a free slot,
+        // so it cannot be further on than a group with an empty slot.
+        if (group.match(POSITION_SLOT_EMPTY) != 0) {
+            break;
+        }
+
+        group_index = (group_index + step) & this->group_mask;
+    }
+
+    return this->capacity();
+}
+
+template<typename Value>
+std::size_t shashki::PositionMap<Value>::find_free_slot(unsigned long long hash) const
+{
+    std::size_t group_index = (hash >> 7) & this->group_mask;
+
+    // There is always a free slot, since the table grows before it is full.
+    for (std::size_t step = 1; ; step++) {
+        unsigned int mask = this->groups[group_index].match_free();
+
+        if (mask != 0) {
+            return group_index * 16 + __builtin_ctz(mask);
+        }
+
+        group_index = (group_index + step) & this->group_mask;
+    }
+}
+
+template<typename Value>
+void shashki::PositionMap<Value>::rehash(std::size_t group_count)
+{
+    // Both arrays are allocated before the map is touched, so it keeps its positions if an allocation fails.
+    std::unique_ptr<PositionGroup[]> new_groups = std::unique_ptr<PositionGroup[]>(new PositionGroup[group_count]);
+    std::unique_ptr<PositionSlot<Value>[]> new_slots = std::unique_ptr<PositionSlot<Value>[]>(new PositionSlot<Value>[group_count * 16]);
+
+    for (std::size_t i = 0; i < group_count; i++) {
+        for (signed char& control : new_groups[i].controls) {
+            control = POSITION_SLOT_EMPTY;
+        }
+    }
+
+    std::size_t old_capacity = this->groups ? this->capacity() : 0;
+    std::unique_ptr<PositionGroup[]> old_groups = std::move(this->groups);
+    std::unique_ptr<PositionSlot<Value>[]> old_slots = std::move(this->slots);
+
+    this->groups = std::move(new_groups);
+    this->slots = std::move(new_slots);
+    this->group_mask = group_count - 1;
+    this->deleted_slots = 0;
+
+    for (std::size_t i = 0; i < old_capacity; i++) {
+        if (old_groups[i / 16].controls[i % 16] < 0) {
+            continue;
+        }
+
+        PositionSlot<Value>& old_slot = old_slots[i];
+        unsigned long long hash = zobrist_hash(Position(BitBoard(old_slot.white_men, old_slot.white_kings,
+                                                                 old_slot.black_men, old_slot.black_kings),
+                                                        old_slot.current_turn));
+        std::size_t slot_index = this->find_free_slot(hash);
+
+        this->groups[slot_index / 16].controls[slot_index % 16] = (signed char) (hash & 0x7F);
+        this->slots[slot_index] = std::move(old_slot);
+    }
+}
+
+template<typename Value>
+bool shashki::PositionMap<Value>::insert(const Position& position,
+                                         const Value& value)
+{
+    unsigned long long hash = zobrist_hash(position);
+
+    if (this->find_slot(position, hash) != this->capacity()) {
+        return false;
+    }
+
+    // Grow at a load of 7/8 (or only clean up if the deleted slots are a big part of it).
+    if ((this->full_slots + this->deleted_slots + 1) * 8 > this->capacity() * 7) {
+        this->rehash(this->deleted_slots > this->full_slots / 2 ? this->group_mask + 1 : (this->group_mask + 1) * 2);
+    }
+
+    std::size_t slot_index = this->find_free_slot(hash);
+    signed char& control = this->groups[slot_index / 16].controls[slot_index % 16];
+    PositionSlot<Value>& slot = this->slots[slot_index];
+
+    if (control == POSITION_SLOT_DELETED) {
+        this->deleted_slots--;
+    }
+
+    control = (signed char) (hash & 0x7F);
+    slot.white_men = position.bit_board.white_men;
+    slot.white_kings = position.bit_board.white_kings;
+    slot.black_men = position.bit_board.black_men;
+    slot.black_kings = position.bit_board.black_kings;
+    slot.current_turn = position.current_turn;
+    slot.value = value;
+    this->full_slots++;
+
+    return true;
+}
+
+template<typename Value>
+Value& shashki::PositionMap<Value>::operator [] (const Position& position)
+{
+    Value* value = this->find(position);
+
+    if (value == NULL) {
+        this->insert(position);
+        value = this->find(position);
+    }
+
+    return *value;
+}
+
+template<typename Value>
+Value* shashki::PositionMap<Value>::find(const Position& position)
+{
+    std::size_t slot_index = this->find_slot(position, zobrist_hash(position));
+
+    return slot_index != this->capacity() ? &this->slots[slot_index].value : NULL;
+}
+
+template<typename Value>
+const Value* shashki::PositionMap<Value>::find(const Position& position) const
+{
+    std::size_t slot_index = this->find_slot(position, zobrist_hash(position));
+
+    return slot_index != this->capacity() ? &this->slots[slot_index].value : NULL;
+}
+
+template<typename Value>
+bool shashki::PositionMap<Value>::contains(const Position& position) const
+{
+    return this->find_slot(position, zobrist_hash(position)) != this->capacity();
+}
+
+template<typename Value>
+bool shashki::PositionMap<Value>::erase(const Position& position)
+{
+    std::size_t slot_index = this->find_slot(position, zobrist_hash(position));
+
+    if (slot_index == this->capacity()) {
+        return false;
+    }
+
+    PositionGroup& group = this->groups[slot_index / 16];
+
+    // If the group has an empty slot, no probing goes on past it and the slot can be empty as well.
+    // Otherwise positions further on may have passed this group, so the slot is only marked as deleted.
+    if (group.match(POSITION_SLOT_EMPTY) != 0) {
+        group.controls[slot_index % 16] = POSITION_SLOT_EMPTY;
+    } else {
+        group.controls[slot_index % 16] = POSITION_SLOT_DELETED;
+        this->deleted_slots++;
+    }
+
+    this->slots[slot_index].value = Value();
+    this->full_slots--;
+
+    return true;
+}
+
+template<typename Value>
+void shashki::PositionMap<Value>::reserve(std::size_t size)
+{
+    std::size_t group_count = this->group_mask + 1;
+
+    while (size * 8 > group_count * 16 * 7) {
+        group_count = group_count * 2;
+    }
+
+    if (group_count != this->group_mask + 1) {
+        this->rehash(group_count);
+    }
+}
+
+template<typename Value>
+void shashki::PositionMap<Value>::clear()
+{
+    for (std::size_t i = 0; i < this->capacity(); i++) {
+        signed char& control = this->groups[i / 16].controls[i % 16];
+
+        if (control >= 0) {
+            this->slots[i].value = Value();
+        }
+
+        control = POSITION_SLOT_EMPTY;
+    }
+
+    this->full_slots = 0;
+    this->deleted_slots = 0;
+}
+
+template<typename Value>
+std::size_t shashki::PositionMap<Value>::size() const
+{
+    return this->full_slots;
+}
+
+template<typename Value>
+std::size_t shashki::PositionMap<Value>::capacity() const
+{
+    return (this->group_mask + 1) * 16;
+}
+
+template<typename Value>
+template<typename Function>
+void shashki::PositionMap<Value>::for_each(Function&& function) const
+{
+    for (std::size_t i = 0; i < this->capacity(); i++) {
+        if (this->groups[i / 16].controls[i % 16] < 0) {
+            continue;
+        }
+
+        const PositionSlot<Value>& slot = this->slots[i];
+
+        function(Position(BitBoard(slot.white_men, slot.white_kings, slot.black_men, slot.black_kings), slot.current_turn),
+                 slot.value);
+    }
+}
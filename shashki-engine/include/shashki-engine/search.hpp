@@ -0,0 +1,176 @@
+/**
+ * Project: Shashki-Engine
+ * Library: shashki-engine
+ * Author:  Jean-Luc Düe
+ * Module:  search
+ *
+ * This module includes the alpha-beta search with a transposition table
+ * and the batch analysis of many positions at once.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "shashki-engine/common.hpp"
+#include "shashki-engine/evaluation.hpp"
+
+namespace shashki
+{
+
+/**
+ * The score of a won position. A side that cannot move anymore has lost and
+ * scores -SEARCH_WIN_SCORE plus the number of plies from the root, so that
+ * faster wins are preferred. All other scores are evaluations (see "evaluate_position()").
+ */
+const int SEARCH_WIN_SCORE = 10000;
+
+/**
+ * The maximum depth a search can be started with.
+ */
+const int MAX_SEARCH_DEPTH = 64;
+
+/**
+ * The kind of score stored in a TranspositionEntry:
+ * EXACT is the real score, LOWER and UPPER are bounds of it
+ * (the search was cut off or no move reached alpha).
+ */
+enum class ScoreBound : unsigned char
+{
+    NONE,
+    EXACT,
+    LOWER,
+    UPPER
+};
+
+/**
+ * A TranspositionEntry holds the search outcome of one position in 16 bytes.
+ * The score is from the view of the side to move. best_child is the index of
+ * the best child in the order of "generate_distinct_bit_boards_for_position()".
+ */
+struct TranspositionEntry
+{
+    unsigned long long  key;
+    short               score;
+    signed char         depth;
+    ScoreBound          bound;
+    unsigned short      best_child;
+};
+
+/**
+ * The TranspositionTable is a fixed size table of TranspositionEntries
+ * indexed by the Zobrist hash of the position. It is not synchronised,
+ * so a table can only be used by one thread at a time.
+ */
+class TranspositionTable
+{
+    private:
+
+    std::unique_ptr<TranspositionEntry[]>   entries;
+    std::size_t                             mask;
+
+    public:
+
+    /**
+     * Constructs an empty table with the given number of entries
+     * rounded down to a power of two (but at least one entry).
+     */
+    TranspositionTable(std::size_t entry_count);
+
+    /**
+     * Asks the processor to load the entry of the given key into the cache
+     * without waiting for it, so that a later "probe()" does not stall.
+     */
+    void prefetch(unsigned long long key) const;
+
+    /**
+     * Returns true and copies the entry into entry if there is one for the given key.
+     */
+    bool probe(unsigned long long key, TranspositionEntry& entry) const;
+
+    /**
+     * Stores the entry. An entry of the same position is only replaced
+     * by one that is searched at least as deep, entries of other positions always.
+     */
+    void store(const TranspositionEntry& entry);
+
+    /**
+     * Removes all the entries.
+     */
+    void clear();
+
+    /**
+     * Returns the number of entries.
+     */
+    std::size_t size() const;
+};
+
+/**
+ * The SearchConfig holds the settings of the search.
+ * singular_extensions enables the extension of singular moves: if the child of the
+ * TranspositionEntry of a node has been searched with a score of at least s and all
+ * the other children stay below s - singular_margin in a search of half the depth,
+ * the child is searched one ply deeper. This is only tried at nodes with at least
+ * singular_depth plies left. In Shashki the capture obligation makes forcing lines
+ * (sacrifices and the combos following them) common, which is where single moves stand out.
+ */
+struct SearchConfig
+{
+    bool    singular_extensions;
+    int     singular_depth;
+    int     singular_margin;
+
+    /**
+     * Constructs the default configuration: singular extensions are disabled,
+     * if enabled they are tried at nodes with at least 4 plies left and a margin of 100 (one Man).
+     */
+    SearchConfig();
+};
+
+/**
+ * The SearchResult holds the outcome of the search of one position.
+ * best_bit_board is the BitBoard that shall be reached with the best move
+ * (the position itself if there is no move at all). score is the score of the
+ * position in hundredths of a Man (positive means White has the advantage),
+ * nodes the number of visited nodes (including the verification searches of the
+ * singular extensions), singular_extensions the number of extended children and
+ * evaluation_statistics the statistics of the (lazy) evaluations of the leaves,
+ * which get the search window passed.
+ */
+struct SearchResult
+{
+    BitBoard                best_bit_board;
+    int                     score;
+    unsigned long long      nodes;
+    unsigned long long      singular_extensions;
+    EvaluationStatistics    evaluation_statistics;
+};
+
+/**
+ * Searches the given Position with alpha-beta (negamax) and iterative deepening to the
+ * given depth and uses the table for move ordering, cut-offs and singular extensions.
+ * Throws std::invalid_argument if the depth is not between 0 and MAX_SEARCH_DEPTH
+ * or the config is invalid (a singular_depth below 2 or a negative singular_margin).
+ */
+SearchResult search_position(const Position& position,
+                             int depth,
+                             TranspositionTable& table,
+                             const SearchConfig& config = SearchConfig());
+
+/**
+ * Searches all the given positions like "search_position()" on the calling thread and
+ * returns their SearchResults in the same order. Up to interleaved_searches positions are
+ * searched at the same time: every search is a state machine with an explicit stack and
+ * whenever one enters a new node, it prefetches the TranspositionEntry and the next search
+ * continues. By the time the first one probes the table, its entry is most likely in the cache.
+ * With interleaved_searches of 1 (or 0) the positions are searched one after another.
+ * Throws std::invalid_argument like "search_position()".
+ */
+std::vector<SearchResult> analyse_positions(const std::vector<Position>& positions,
+                                            int depth,
+                                            TranspositionTable& table,
+                                            std::size_t interleaved_searches,
+                                            const SearchConfig& config = SearchConfig());
+
+}
@@ -0,0 +1,60 @@
+/**
+ * Project: Shashki-Engine
+ * Library: shashki-engine
+ * Author:  Jean-Luc Düe
+ * Module:  threats
+ *
+ * This module includes functionality for calculating set-wise threat
+ * and attack information of a BitBoard for both sides.
+ */
+
+#pragma once
+
+#include "shashki-engine/common.hpp"
+
+namespace shashki
+{
+
+/**
+ * A ThreatMap holds the threat information of one side as 64-bit integers
+ * (one bit per board position like in the BitBoard):
+ * attacked_pieces are the pieces of this side the opponent can jump right now.
+ * controlled_squares are the positions where this side could jump an opponents piece
+ * if it stood there (the occupied ones are the attacked_pieces of the opponent).
+ * safe_squares are the empty positions this side can move to with a normal move
+ * that are not controlled by the opponent (with respect to the current constellation).
+ * capturing_pieces are the pieces of this side that can jump right now. As jumping is obligatory
+ * in Shashki, if there is any, the side is pinned to the capture obligation and all of its
+ * other pieces cannot move at all.
+ */
+struct ThreatMap
+{
+    unsigned long long  attacked_pieces;
+    unsigned long long  controlled_squares;
+    unsigned long long  safe_squares;
+    unsigned long long  capturing_pieces;
+};
+
+/**
+ * Threats holds the ThreatMaps of both sides of one BitBoard.
+ */
+struct Threats
+{
+    ThreatMap   white;
+    ThreatMap   black;
+
+    /**
+     * Returns the ThreatMap of the given side.
+     */
+    const ThreatMap& of_side(Side side) const;
+};
+
+/**
+ * Calculates the Threats of the given BitBoard in a single pass over the four
+ * diagonal directions. Men are handled for all of them at once with bit-operations,
+ * Kings with precalculated ray tables. No moves are generated for this.
+ * This is meant to be cheap enough for evaluation, move ordering and pruning decisions.
+ */
+Threats calculate_threats(const BitBoard& bit_board);
+
+}
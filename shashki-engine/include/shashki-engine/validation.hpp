@@ -0,0 +1,144 @@
+/**
+ * Project: Shashki-Engine
+ * Library: shashki-engine
+ * Author:  Jean-Luc Düe
+ * Module:  validation
+ *
+ * This module includes functionality for checking recorded games
+ * for legality in bulk.
+ */
+
+#pragma once
+
+#include <vector>
+#include "shashki-engine/common.hpp"
+
+namespace shashki
+{
+
+/**
+ * A PackedMove is the compact representation of one complete move path
+ * (a single move or a whole combo of jumps) as it is stored in game records.
+ * The source and target positions are packed into the 16-bit squares member
+ * (source in the lower 6 bits, target in the next 6 bits).
+ * captures holds the bits of all the pieces jumped in this move path
+ * and is 0 for a normal move.
+ */
+struct PackedMove
+{
+    unsigned long long  captures;
+    unsigned short      squares;
+
+    /**
+     * Constructs a PackedMove from the source and target positions
+     * and the jumped pieces.
+     */
+    PackedMove(int source_position,
+               int target_position,
+               unsigned long long captures);
+
+    /**
+     * Compares a PackedMove to another PackedMove.
+     * Source, target and the jumped pieces must be identic
+     * in order to return true for this comparison.
+     */
+    bool operator == (const PackedMove& packed_move) const;
+
+    /**
+     * Returns the position the moving piece starts from.
+     */
+    int source_position() const;
+
+    /**
+     * Returns the position the moving piece ends on.
+     */
+    int target_position() const;
+};
+
+/**
+ * The result of a recorded game. UNKNOWN is used for games
+ * that are unfinished or whose result has not been recorded.
+ */
+enum class GameResult
+{
+    UNKNOWN,
+    WHITE_WIN,
+    DRAW,
+    BLACK_WIN
+};
+
+/**
+ * A GameRecord is a recorded game: the position it starts from,
+ * the PackedMoves played from there on (alternating between the sides)
+ * and the result of the game.
+ */
+struct GameRecord
+{
+    Position                start_position;
+    std::vector<PackedMove> moves;
+    GameResult              result;
+
+    /**
+     * Constructs an empty GameRecord starting from the start constellation
+     * with an UNKNOWN result.
+     */
+    GameRecord();
+};
+
+/**
+ * Returns the PackedMove that leads from the given position to the target_bit_board,
+ * which must be the result of a legal move path (e.g. from "generate_bit_boards_for_position()").
+ * A combo can end on its source position again, in that case the piece is found
+ * by generating its jumps and source and target are both set to that position.
+ * Throws std::invalid_argument if the pieces of the side to move are unchanged
+ * and no piece can jump into the target_bit_board. Other illegal targets are not detected,
+ * "execute_packed_move()" checks the returned PackedMove if that is needed.
+ */
+PackedMove packed_move_between(const Position& position,
+                               const BitBoard& target_bit_board);
+
+/**
+ * Same as "packed_move_between()" but generates the jumps of a combo that ended on its source
+ * position into the given list instead of a new one, so that its memory can be reused.
+ */
+PackedMove packed_move_between(const Position& position,
+                               const BitBoard& target_bit_board,
+                               std::vector<BitBoard>& bit_boards);
+
+/**
+ * Checks the PackedMove for legality in the given position directly
+ * (without generating all the moves of the position) and executes it if it is legal.
+ * Returns true and alters the position (BitBoard and side to move) if the move is legal.
+ * Returns false and leaves the position untouched if it is not.
+ */
+bool execute_packed_move(Position& position,
+                         const PackedMove& packed_move);
+
+/**
+ * Same as "execute_packed_move()" but generates the paths of the moving piece into the given
+ * list instead of a new one, so that replaying many plies does not allocate for every ply.
+ */
+bool execute_packed_move(Position& position,
+                         const PackedMove& packed_move,
+                         std::vector<BitBoard>& bit_boards);
+
+/**
+ * Replays the GameRecord and returns the index of the first illegal ply
+ * or -1 if all plies are legal.
+ */
+int first_illegal_ply(const GameRecord& game_record);
+
+/**
+ * Same as "first_illegal_ply()" but uses the given list as working memory of "execute_packed_move()".
+ */
+int first_illegal_ply(const GameRecord& game_record,
+                      std::vector<BitBoard>& bit_boards);
+
+/**
+ * Replays all the GameRecords split by game across thread_count threads.
+ * Returns the result of "first_illegal_ply()" for every GameRecord in the same order.
+ */
+std::vector<int> validate_game_records(const std::vector<GameRecord>& game_records,
+                                       unsigned int thread_count);
+
+}
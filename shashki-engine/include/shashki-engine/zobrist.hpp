@@ -0,0 +1,84 @@
+/**
+ * Project: Shashki-Engine
+ * Library: shashki-engine
+ * Author:  Jean-Luc Düe
+ * Module:  zobrist
+ *
+ * This module includes functionality for hashing positions
+ * with the Zobrist technique.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include "shashki-engine/common.hpp"
+
+namespace shashki
+{
+
+/**
+ * Returns the 64-bit Zobrist hash of the pieces on the given BitBoard.
+ * Every side/type combination on every board position has its own random
+ * 64-bit key and the hash is the XOR combination of the keys of all the pieces.
+ * The keys are generated from a fixed seed, so the hashes are the same
+ * in every run and can be stored in files.
+ */
+unsigned long long zobrist_hash(const BitBoard& bit_board);
+
+/**
+ * Returns the 64-bit Zobrist hash of the given Position: the hash of its BitBoard
+ * combined with one more key if Black is to move.
+ */
+unsigned long long zobrist_hash(const Position& position);
+
+/**
+ * Returns the 64-bit Zobrist hash of the current situation of the given Game
+ * (its BitBoard and the side in turn), which the Game keeps up to date incrementally.
+ */
+unsigned long long zobrist_hash(const Game& game);
+
+/**
+ * Updates the hash of source_bit_board to the hash of target_bit_board incrementally.
+ * Only the keys of the pieces that differ are combined, which are just a few
+ * after a move (the moving piece and the jumped ones). The side to move is not changed.
+ */
+unsigned long long zobrist_hash_update(unsigned long long hash,
+                                       const BitBoard& source_bit_board,
+                                       const BitBoard& target_bit_board);
+
+/**
+ * Returns the hash of the Position reached by a complete move path (after which the
+ * other side is to move) from the hash of the Position with source_bit_board.
+ */
+unsigned long long zobrist_hash_after_move(unsigned long long hash,
+                                           const BitBoard& source_bit_board,
+                                           const BitBoard& target_bit_board);
+
+}
+
+namespace std
+{
+
+/**
+ * The hashes of BitBoards and Positions for the standard containers (e.g. std::unordered_set).
+ */
+template<>
+struct hash<shashki::BitBoard>
+{
+    std::size_t operator () (const shashki::BitBoard& bit_board) const
+    {
+        return shashki::zobrist_hash(bit_board);
+    }
+};
+
+template<>
+struct hash<shashki::Position>
+{
+    std::size_t operator () (const shashki::Position& position) const
+    {
+        return shashki::zobrist_hash(position);
+    }
+};
+
+}
@@ -0,0 +1,142 @@
+#include "shashki-engine/adjudication.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include "shashki-engine/move-generation.hpp"
+#include "shashki-engine/threats.hpp"
+#include "internal.hpp"
+
+shashki::AdjudicationConfig::AdjudicationConfig()
+    : score_threshold(400),
+      score_plies(12),
+      repetitions(3),
+      king_move_plies(30),
+      use_recogniser(true),
+      verdict_probe() {}
+
+/**
+ * Recognises a single King of the weak_side against only Kings of the other side.
+ * Returns DRAW if the weak_side can hold the position or UNKNOWN otherwise.
+ */
+shashki::GameResult recognise_single_king(const shashki::BitBoard& bit_board,
+                                          shashki::Side weak_side)
+{
+    unsigned long long weak_kings = bit_board.pieces_of_side_and_type(weak_side, shashki::PieceType::KING);
+    unsigned long long strong_kings = bit_board.pieces_of_side_and_type(shashki::side_opposite(weak_side), shashki::PieceType::KING);
+
+    if (__builtin_popcountll(weak_kings) != 1 || bit_board.blocking_board_of_side(weak_side) != weak_kings
+        || bit_board.blocking_board_of_side(shashki::side_opposite(weak_side)) != strong_kings) {
+        return shashki::GameResult::UNKNOWN;
+    }
+
+    shashki::Threats threats = shashki::calculate_threats(bit_board);
+
+    if (threats.white.attacked_pieces != 0 || threats.black.attacked_pieces != 0) {
+        return shashki::GameResult::UNKNOWN;
+    }
+
+    int strong_king_count = __builtin_popcountll(strong_kings);
+
+    if (strong_king_count <= 2 || (strong_king_count == 3 && (weak_kings & MAIN_DIAGONAL))) {
+        return shashki::GameResult::DRAW;
+    }
+
+    return shashki::GameResult::UNKNOWN;
+}
+
+shashki::GameResult shashki::recognise_position(const Position& position)
+{
+    const BitBoard& bit_board = position.bit_board;
+
+    if (bit_board.blocking_board_of_side(Side::WHITE) == 0) {
+        return GameResult::BLACK_WIN;
+    }
+
+    if (bit_board.blocking_board_of_side(Side::BLACK) == 0) {
+        return GameResult::WHITE_WIN;
+    }
+
+    if (recognise_single_king(bit_board, Side::WHITE) == GameResult::DRAW
+        || recognise_single_king(bit_board, Side::BLACK) == GameResult::DRAW) {
+        return GameResult::DRAW;
+    }
+
+    return GameResult::UNKNOWN;
+}
+
+shashki::Adjudicator::Adjudicator(const AdjudicationConfig& config)
+    : config(config),
+      reversible_positions(std::vector<Position>()),
+      white_score_plies(0),
+      black_score_plies(0)
+{
+    if (config.score_plies < 0 || config.repetitions < 0 || config.king_move_plies < 0) {
+        throw std::invalid_argument("Adjudication thresholds must not be negative.");
+    }
+
+    if (config.repetitions == 1) {
+        throw std::invalid_argument("Adjudication by repetition needs at least two occurrences.");
+    }
+
+    if (config.score_plies > 0 && config.score_threshold < 1) {
+        throw std::invalid_argument("Adjudication by score needs a score threshold of at least 1.");
+    }
+}
+
+shashki::Adjudication shashki::Adjudicator::adjudicate(const Position& position,
+                                                       int score)
+{
+    // 1. The regular end of the game: the side in turn cannot move anymore.
+    if (generate_bit_boards_for_position(position).empty()) {
+        return Adjudication{position.current_turn == Side::WHITE ? GameResult::BLACK_WIN : GameResult::WHITE_WIN,
+                            AdjudicationReason::NO_MOVES};
+    }
+
+    // 2. A capture or a Man move can never be undone, so earlier positions cannot repeat anymore.
+    if (!this->reversible_positions.empty()) {
+        const BitBoard& last_bit_board = this->reversible_positions.back().bit_board;
+
+        if (last_bit_board.white_men != position.bit_board.white_men
+            || last_bit_board.black_men != position.bit_board.black_men
+            || __builtin_popcountll(last_bit_board.blocking_board()) != __builtin_popcountll(position.bit_board.blocking_board())) {
+            this->reversible_positions.clear();
+        }
+    }
+
+    this->reversible_positions.push_back(position);
+
+    // 3. Draws by the rules: repetition and too many King moves.
+    if (this->config.repetitions > 0
+        && std::count(this->reversible_positions.begin(), this->reversible_positions.end(), position) >= this->config.repetitions) {
+        return Adjudication{GameResult::DRAW, AdjudicationReason::REPETITION};
+    }
+
+    if (this->config.king_move_plies > 0 && (int) this->reversible_positions.size() - 1 >= this->config.king_move_plies) {
+        return Adjudication{GameResult::DRAW, AdjudicationReason::KING_MOVES};
+    }
+
+    // 4. Known verdicts of the probe (e.g. a bitbase) and the recogniser.
+    GameResult verdict = this->config.verdict_probe ? this->config.verdict_probe(position) : GameResult::UNKNOWN;
+
+    if (verdict == GameResult::UNKNOWN && this->config.use_recogniser) {
+        verdict = recognise_position(position);
+    }
+
+    if (verdict != GameResult::UNKNOWN) {
+        return Adjudication{verdict, AdjudicationReason::RECOGNISER};
+    }
+
+    // 5. The score has to stay beyond the threshold for score_plies consecutive plies.
+    this->white_score_plies = score >= this->config.score_threshold ? this->white_score_plies + 1 : 0;
+    this->black_score_plies = score <= -this->config.score_threshold ? this->black_score_plies + 1 : 0;
+
+    if (this->config.score_plies > 0 && this->white_score_plies >= this->config.score_plies) {
+        return Adjudication{GameResult::WHITE_WIN, AdjudicationReason::SCORE};
+    }
+
+    if (this->config.score_plies > 0 && this->black_score_plies >= this->config.score_plies) {
+        return Adjudication{GameResult::BLACK_WIN, AdjudicationReason::SCORE};
+    }
+
+    return Adjudication{GameResult::UNKNOWN, AdjudicationReason::NONE};
+}
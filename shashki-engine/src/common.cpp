@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <iterator>
 #include <random>
+#include "shashki-engine/zobrist.hpp"
 
 shashki::Side shashki::side_opposite(Side side)
 {
@@ -96,6 +97,21 @@ shashki::PieceType shashki::BitBoard::piece_type_on_position(int position) const
     return (this->white_men | this->black_men) & (1ULL << position) ? PieceType::MAN : PieceType::KING;
 }
 
+shashki::Position::Position()
+    : bit_board(BitBoard()),
+      current_turn(Side::WHITE) {}
+
+shashki::Position::Position(BitBoard bit_board,
+                            Side current_turn)
+    : bit_board(bit_board),
+      current_turn(current_turn) {}
+
+bool shashki::Position::operator==(const Position& position) const
+{
+    return this->bit_board == position.bit_board
+        && this->current_turn == position.current_turn;
+}
+
 shashki::Move::Move(Piece moving_piece,
                     int target_position,
                     std::optional<Piece> attacked_piece,
@@ -254,7 +270,8 @@ const std::vector<shashki::Move>& shashki::Move::get_follow_moves() const
 shashki::Game::Game()
     : bit_board(BitBoard()),
       current_turn(Side::WHITE),
-      executed_moves(std::vector<Move>()) {}
+      executed_moves(std::vector<Move>()),
+      zobrist_key(zobrist_hash(Position())) {}
 
 bool shashki::Game::operator==(const Game& game) const
 {
@@ -270,6 +287,13 @@ void shashki::Game::execute_move(const Move& move)
     // Clear the follow_moves from the recently added move.
     this->executed_moves.back().clear_follow_moves();
 
+    // Update the Zobrist key from the current to the new situation (see below for the turn).
+    if (move.get_follow_moves().empty()) {
+        this->zobrist_key = zobrist_hash_after_move(this->zobrist_key, this->bit_board, this->executed_moves.back().get_target_bit_board());
+    } else {
+        this->zobrist_key = zobrist_hash_update(this->zobrist_key, this->bit_board, this->executed_moves.back().get_target_bit_board());
+    }
+
     // Alter the current BitBoard situation of the game based on the
     // target_bit_board of the recently added move.
     this->bit_board = this->executed_moves.back().get_target_bit_board();
@@ -299,7 +323,8 @@ void shashki::Game::undo_last_move()
         this->executed_moves.pop_back();
     }
 
-    // Alter the BitBoard situation accordingly.
+    // Alter the BitBoard situation accordingly (the side in turn stays the same).
+    this->zobrist_key = zobrist_hash_update(this->zobrist_key, this->bit_board, this->executed_moves.back().get_target_bit_board());
     this->bit_board = this->executed_moves.back().get_target_bit_board();
 }
 
@@ -343,3 +368,8 @@ const std::vector<shashki::Move>& shashki::Game::get_executed_moves() const
 {
     return this->executed_moves;
 }
+
+const unsigned long long& shashki::Game::get_zobrist_key() const
+{
+    return this->zobrist_key;
+}
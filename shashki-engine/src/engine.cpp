@@ -54,29 +54,6 @@ struct EngineResult
           ancestor_move_bit_board(ancestor_move_bit_board) {}
 };
 
-/**
- * This function converts a move with all its possible combos
- * into child nodes of the engine tree. Each ending of a combo move path
- * will result into a BitBoard that is used for creating one child.
- * 
- * Example:
- * If there is a move where it is possible to jump in two different directions
- * and for both directions there is another following jump possible in two different
- * directions then there are four different BitBoard outcomes for this move combo.
- * This means four new child nodes are created for the given parent node (engine_node).
- */
-void convert_move_combo_to_child_nodes(EngineNode& engine_node,
-                                       const shashki::Move& move)
-{
-    if (move.get_follow_moves().empty()) {
-        engine_node.child_nodes.push_front(EngineNode(move.get_target_bit_board()));
-    } else {
-        for (const shashki::Move& follow_move : move.get_follow_moves()) {
-            convert_move_combo_to_child_nodes(engine_node, follow_move);
-        }
-    }
-}
-
 /**
  * This function does two important things.
  * 1. It creates child nodes for the given engine_node (parent).
@@ -95,6 +72,7 @@ void convert_move_combo_to_child_nodes(EngineNode& engine_node,
 EngineResult build_and_evaluate(EngineNode& engine_node,
                                 shashki::Side side,
                                 int depth,
+                                std::vector<shashki::CaptureState>& visited_states,
                                 int alpha = -100,
                                 int beta = 100,
                                 shashki::BitBoard* ancestor_move_bit_board = NULL)
@@ -104,17 +82,19 @@ EngineResult build_and_evaluate(EngineNode& engine_node,
         return EngineResult(shashki::evaluate_bit_board(engine_node.bit_board), ancestor_move_bit_board);
     }
 
-    // Create possible moves for the current engine_node that is traversed.
-    std::vector<shashki::Move> possible_moves = shashki::generate_moves_for_side(engine_node.bit_board, side);
+    // Create the distinct BitBoards that the possible moves of the current engine_node lead to.
+    // Move combos that end in the same BitBoard only result into one child.
+    std::vector<shashki::BitBoard> child_bit_boards = std::vector<shashki::BitBoard>();
+    shashki::generate_distinct_bit_boards_for_position(shashki::Position(engine_node.bit_board, side), child_bit_boards, visited_states);
 
     // If there are no moves possible, return the evaluation of this depth.
-    if (possible_moves.empty()) {
+    if (child_bit_boards.empty()) {
         return EngineResult(shashki::evaluate_bit_board(engine_node.bit_board), ancestor_move_bit_board);
     }
 
-    // Convert the move combos into child nodes and attach them to the current engine_node.
-    for (const shashki::Move& move : possible_moves) {
-        convert_move_combo_to_child_nodes(engine_node, move);
+    // Convert the BitBoards into child nodes and attach them to the current engine_node.
+    for (const shashki::BitBoard& child_bit_board : child_bit_boards) {
+        engine_node.child_nodes.push_front(EngineNode(child_bit_board));
     }
 
     // The minimax evaluation with alpha- and beta- pruning follows.
@@ -122,7 +102,7 @@ EngineResult build_and_evaluate(EngineNode& engine_node,
         EngineResult maximum = EngineResult(-100, NULL);
 
         for (EngineNode& child_node : engine_node.child_nodes) {
-            EngineResult evaluation = build_and_evaluate(child_node, shashki::Side::BLACK, depth - 1, alpha, beta,
+            EngineResult evaluation = build_and_evaluate(child_node, shashki::Side::BLACK, depth - 1, visited_states, alpha, beta,
                                                          ancestor_move_bit_board == NULL ? &child_node.bit_board : ancestor_move_bit_board);
             
             if (evaluation.evaluation_value > maximum.evaluation_value) {
@@ -143,7 +123,7 @@ EngineResult build_and_evaluate(EngineNode& engine_node,
         EngineResult minimum = EngineResult(100, NULL);
 
         for (EngineNode& child_node : engine_node.child_nodes) {
-            EngineResult evaluation = build_and_evaluate(child_node, shashki::Side::WHITE, depth - 1, alpha, beta,
+            EngineResult evaluation = build_and_evaluate(child_node, shashki::Side::WHITE, depth - 1, visited_states, alpha, beta,
                                                          ancestor_move_bit_board == NULL ? &child_node.bit_board : ancestor_move_bit_board);
             
             if (evaluation.evaluation_value < minimum.evaluation_value) {
@@ -169,7 +149,9 @@ shashki::Move shashki::best_move(const Game& game,
     // Create the start node from the current game situation.
     EngineNode start_node = EngineNode(game.get_bit_board());
     // Build the engine tree and evaluate to get the best EngineResult.
-    EngineResult engine_result = build_and_evaluate(start_node, game.get_current_turn(), depth);
+    // The working memory of the move generation is shared by all the nodes.
+    std::vector<CaptureState> visited_states = std::vector<CaptureState>();
+    EngineResult engine_result = build_and_evaluate(start_node, game.get_current_turn(), depth, visited_states);
 
     // Generate the possible moves for the current game situation.
     std::vector<Move> possible_moves = generate_moves_for_game(game);
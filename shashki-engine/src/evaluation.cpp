@@ -1,5 +1,9 @@
 #include "shashki-engine/evaluation.hpp"
 
+#include <algorithm>
+#include "shashki-engine/threats.hpp"
+#include "internal.hpp"
+
 /**
  * The Importance of the Man piece.
  */
@@ -42,3 +46,181 @@ int shashki::evaluate_bit_board(const BitBoard& bit_board)
 
     return evaluation;
 }
+
+// The weights of the tiered evaluation in hundredths of a Man:
+
+const int EVALUATION_MAN = 100;
+const int EVALUATION_KING = 300;
+const int MAN_ROW_BONUSES[8] = {0, 2, 4, 7, 11, 16, 22, 0};
+const int MAN_CENTRE_BONUS = 4;
+const int KING_MAIN_DIAGONAL_BONUS = 15;
+const int SOLID_MAN_BONUS = 3;
+const int BACK_ROW_MAN_BONUS = 6;
+const int SAFE_SQUARE_BONUS = 3;
+const int CAPTURE_BONUS = 25;
+const int ATTACKED_PIECE_PENALTY = 10;
+
+/**
+ * The maximum the structure tier and the expensive tier
+ * can change the evaluation (their results are limited to it).
+ */
+const int STRUCTURE_MARGIN = 50;
+const int EXPENSIVE_MARGIN = 60;
+
+// Bit masks of the board used by the tiered evaluation:
+
+const unsigned long long FILE_A = 0x8080808080808080ULL;
+const unsigned long long FILE_H = 0x0101010101010101ULL;
+const unsigned long long ROW_1 = 0x00000000000000FFULL;
+const unsigned long long CENTRE = 0x00003C3C3C3C0000ULL;
+
+/**
+ * Returns the row of the board (0 to 7) as seen from the given side.
+ */
+unsigned long long relative_row(shashki::Side side,
+                                int row)
+{
+    return ROW_1 << ((side == shashki::Side::WHITE ? row : 7 - row) * 8);
+}
+
+/**
+ * The first tier: material and piece-square bonuses of one side.
+ */
+int evaluate_material_tier(const shashki::BitBoard& bit_board,
+                           shashki::Side side)
+{
+    unsigned long long men = bit_board.pieces_of_side_and_type(side, shashki::PieceType::MAN);
+    unsigned long long kings = bit_board.pieces_of_side_and_type(side, shashki::PieceType::KING);
+    int evaluation = __builtin_popcountll(men) * EVALUATION_MAN + __builtin_popcountll(kings) * EVALUATION_KING;
+
+    for (int row = 1; row < 7; row++) {
+        evaluation += __builtin_popcountll(men & relative_row(side, row)) * MAN_ROW_BONUSES[row];
+    }
+
+    evaluation += __builtin_popcountll(men & CENTRE) * MAN_CENTRE_BONUS;
+    evaluation += __builtin_popcountll(kings & MAIN_DIAGONAL) * KING_MAIN_DIAGONAL_BONUS;
+
+    return evaluation;
+}
+
+/**
+ * The second tier: the structure of the Men of one side.
+ * A Man is solid if it cannot be jumped from the front, because both positions behind it
+ * are occupied by own pieces or off the board. Men on the own back row keep the opponents
+ * Men from getting promoted, as long as the opponent has any.
+ */
+int evaluate_structure_tier(const shashki::BitBoard& bit_board,
+                            shashki::Side side)
+{
+    unsigned long long men = bit_board.pieces_of_side_and_type(side, shashki::PieceType::MAN);
+    unsigned long long own_bit_board = bit_board.blocking_board_of_side(side);
+    unsigned long long back_row = relative_row(side, 0);
+    unsigned long long covered_left = 0;
+    unsigned long long covered_right = 0;
+
+    if (side == shashki::Side::WHITE) {
+        covered_left = ((own_bit_board & ~FILE_H) << 7) | FILE_A | back_row;
+        covered_right = ((own_bit_board & ~FILE_A) << 9) | FILE_H | back_row;
+    } else {
+        covered_left = ((own_bit_board & ~FILE_H) >> 9) | FILE_A | back_row;
+        covered_right = ((own_bit_board & ~FILE_A) >> 7) | FILE_H | back_row;
+    }
+
+    int evaluation = __builtin_popcountll(men & covered_left & covered_right) * SOLID_MAN_BONUS;
+
+    if (bit_board.pieces_of_side_and_type(shashki::side_opposite(side), shashki::PieceType::MAN) != 0) {
+        evaluation += __builtin_popcountll(men & back_row) * BACK_ROW_MAN_BONUS;
+    }
+
+    return evaluation;
+}
+
+/**
+ * The third tier: mobility and threats from the view of the side in turn.
+ * The side in turn gets a bonus if it can jump right now, otherwise a penalty
+ * for every own piece the opponent is threatening to jump.
+ */
+int evaluate_expensive_tier(const shashki::BitBoard& bit_board,
+                            shashki::Side side)
+{
+    shashki::Threats threats = shashki::calculate_threats(bit_board);
+    const shashki::ThreatMap& own_threats = threats.of_side(side);
+    const shashki::ThreatMap& opponent_threats = threats.of_side(shashki::side_opposite(side));
+
+    int evaluation = (__builtin_popcountll(own_threats.safe_squares) - __builtin_popcountll(opponent_threats.safe_squares)) * SAFE_SQUARE_BONUS;
+
+    if (own_threats.capturing_pieces != 0) {
+        evaluation += CAPTURE_BONUS;
+    } else {
+        evaluation -= __builtin_popcountll(own_threats.attacked_pieces) * ATTACKED_PIECE_PENALTY;
+    }
+
+    return evaluation;
+}
+
+/**
+ * Returns true if the evaluation so far can only end up outside of (alpha, beta),
+ * as the missing tiers change it by at most margin. The bound then is the
+ * closest value to the window the evaluation could still reach.
+ */
+bool lazy_exit(int evaluation,
+               int margin,
+               int alpha,
+               int beta,
+               int& bound)
+{
+    if (evaluation + margin <= alpha) {
+        bound = evaluation + margin;
+        return true;
+    }
+
+    if (evaluation - margin >= beta) {
+        bound = evaluation - margin;
+        return true;
+    }
+
+    return false;
+}
+
+int shashki::evaluate_position(const Position& position,
+                               int alpha,
+                               int beta,
+                               EvaluationStatistics* statistics)
+{
+    const BitBoard& bit_board = position.bit_board;
+    Side side = position.current_turn;
+    Side opponent = side_opposite(side);
+    int bound = 0;
+
+    if (statistics != NULL) {
+        statistics->evaluations++;
+    }
+
+    // 1. Material and piece-square bonuses.
+    int evaluation = evaluate_material_tier(bit_board, side) - evaluate_material_tier(bit_board, opponent);
+
+    if (lazy_exit(evaluation, STRUCTURE_MARGIN + EXPENSIVE_MARGIN, alpha, beta, bound)) {
+        if (statistics != NULL) {
+            statistics->material_exits++;
+        }
+
+        return bound;
+    }
+
+    // 2. Structure.
+    evaluation += std::clamp(evaluate_structure_tier(bit_board, side) - evaluate_structure_tier(bit_board, opponent),
+                             -STRUCTURE_MARGIN, STRUCTURE_MARGIN);
+
+    if (lazy_exit(evaluation, EXPENSIVE_MARGIN, alpha, beta, bound)) {
+        if (statistics != NULL) {
+            statistics->structure_exits++;
+        }
+
+        return bound;
+    }
+
+    // 3. Mobility and threats.
+    evaluation += std::clamp(evaluate_expensive_tier(bit_board, side), -EXPENSIVE_MARGIN, EXPENSIVE_MARGIN);
+
+    return evaluation;
+}
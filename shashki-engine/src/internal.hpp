@@ -0,0 +1,73 @@
+/**
+ * Project: Shashki-Engine
+ * Library: shashki-engine
+ * Author:  Jean-Luc Düe
+ * Module:  internal
+ *
+ * This module includes helpers that are shared by several modules of the library.
+ * It is not part of the public interface (it is not in the include directory).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * The bits of the main diagonal (A1-H8), the "main road" of the board.
+ */
+const unsigned long long MAIN_DIAGONAL = 0x0102040810204080ULL;
+
+/**
+ * Returns the largest power of two that is not above count (but at least 1),
+ * which is the size of a hash table with the given number of entries.
+ * It cannot overflow, not even for the largest counts.
+ */
+inline std::size_t power_of_two_floor(std::size_t count)
+{
+    std::size_t size = 1;
+
+    while (size <= count / 2) {
+        size = size * 2;
+    }
+
+    return size;
+}
+
+/**
+ * Processes the items 0 to item_count - 1 on thread_count threads (the calling thread being one of them).
+ * Every thread takes the next chunk of chunk_size items until none is left and calls
+ * work(thread_index, first, last) for the items first to last - 1 of it. The thread_index
+ * (0 to thread_count - 1, 0 is the calling thread) allows for results per thread.
+ * Returns when all the items have been processed.
+ */
+template<typename Work>
+void process_in_chunks(std::size_t item_count,
+                       std::size_t chunk_size,
+                       unsigned int thread_count,
+                       const Work& work)
+{
+    std::atomic<std::size_t> next_item = 0;
+
+    auto process = [&](unsigned int thread_index) {
+        for (std::size_t first = next_item.fetch_add(chunk_size); first < item_count;
+             first = next_item.fetch_add(chunk_size)) {
+            work(thread_index, first, std::min(first + chunk_size, item_count));
+        }
+    };
+
+    std::vector<std::thread> threads = std::vector<std::thread>();
+
+    for (unsigned int thread_index = 1; thread_index < std::max(thread_count, 1U); thread_index++) {
+        threads.push_back(std::thread(process, thread_index));
+    }
+
+    process(0);
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
@@ -1,5 +1,6 @@
 #include "shashki-engine/move-generation.hpp"
 
+#include <algorithm>
 #include <functional>
 
 /**
@@ -99,6 +100,36 @@ const MoveDirection RIGHT_DOWN = {
         { return side == shashki::Side::BLACK && piece_type == shashki::PieceType::MAN && position < 8; }
 };
 
+// All the MoveDirections in the order they are used by the move generation:
+
+const MoveDirection* const MOVE_DIRECTIONS[] = {&LEFT_UP, &RIGHT_UP, &LEFT_DOWN, &RIGHT_DOWN};
+
+/**
+ * The maximum number of jumps of one move path. Every jump removes another
+ * opponents piece, so there can never be more jumps than pieces on the board.
+ */
+const int MAX_CAPTURE_PATH_LENGTH = 32;
+
+/**
+ * A CaptureFrame is one step of the attack path that "walk_capture_paths()" is walking.
+ * capture_bit_board holds the pieces jumped so far with the piece (a King or not)
+ * standing on the position after them. direction is the MoveDirection that is tried
+ * at the moment, attack_position the opponents piece found into that direction and target_position
+ * the last position tried for landing behind it. landing is true while there are further positions
+ * to land on and jumped is true as soon as there has been any jump from this frame.
+ */
+struct CaptureFrame
+{
+    unsigned long long  capture_bit_board;
+    int                 position;
+    bool                king;
+    int                 direction;
+    int                 attack_position;
+    int                 target_position;
+    bool                landing;
+    bool                jumped;
+};
+
 // Declaration of the helper functions:
 
 void generate_normal_moves(std::vector<shashki::Move>& moves, const shashki::BitBoard& bit_board, const shashki::Side& side, const shashki::PieceType& piece_type, const MoveDirection& move_direction);
@@ -111,6 +142,12 @@ void generate_follow_moves(shashki::Move& move, unsigned long long capture_bit_b
 void generate_follow_move(shashki::Move& move, const MoveDirection& move_direction, unsigned long long capture_bit_board);
 void follow_move_before_enemy(shashki::Move& move, const MoveDirection& move_direction, unsigned long long capture_bit_board, unsigned long long move_bit_board, int move_count);
 void follow_move_after_enemy(shashki::Move& move, const MoveDirection& move_direction, unsigned long long capture_bit_board, unsigned long long move_bit_board, int move_count, int attack_count);
+shashki::BitBoard bit_board_after_step(const shashki::BitBoard& bit_board, const shashki::Side& side, bool king, int source_position, int target_position, unsigned long long attacked_bit);
+bool visit_capture_state(std::vector<shashki::CaptureState>& visited_states, int position, bool king, unsigned long long capture_bit_board);
+template <typename PathVisitor> unsigned long long walk_capture_paths(const shashki::BitBoard& bit_board, const shashki::Side& side, bool king, int position, std::vector<shashki::CaptureState>* visited_states, PathVisitor&& visit_path);
+int generate_capture_bit_boards(std::vector<shashki::BitBoard>& bit_boards, const shashki::BitBoard& bit_board, const shashki::Side& side, bool king, int position);
+void generate_normal_bit_boards(std::vector<shashki::BitBoard>& bit_boards, const shashki::BitBoard& bit_board, const shashki::Side& side, bool king, int position);
+unsigned long long shift_bits(unsigned long long bits, const MoveDirection& move_direction);
 
 // Implementation of the library functions:
 
@@ -175,6 +212,186 @@ std::vector<shashki::Move> shashki::generate_moves_for_piece(const BitBoard& bit
     return moves;
 }
 
+std::vector<shashki::BitBoard> shashki::generate_bit_boards_for_position(const Position& position)
+{
+    std::vector<BitBoard> bit_boards = std::vector<BitBoard>();
+    generate_bit_boards_for_position(position, bit_boards);
+    return bit_boards;
+}
+
+void shashki::generate_bit_boards_for_position(const Position& position,
+                                               std::vector<BitBoard>& bit_boards)
+{
+    bit_boards.clear();
+    const BitBoard& bit_board = position.bit_board;
+    const Side& side = position.current_turn;
+
+    unsigned long long men = bit_board.pieces_of_side_and_type(side, PieceType::MAN);
+    unsigned long long kings = bit_board.pieces_of_side_and_type(side, PieceType::KING);
+
+    // Generate attack (jump) paths first.
+
+    for (unsigned long long pieces = men | kings; pieces != 0; pieces = pieces & (pieces - 1)) {
+        int piece_position = __builtin_ctzll(pieces);
+        generate_capture_bit_boards(bit_boards, bit_board, side, (kings >> piece_position) & 1ULL, piece_position);
+    }
+
+    // Only if there are no attack paths - generate normal moves
+    // as jumping in Shashki is obligatory if it is possible.
+
+    if (!bit_boards.empty()) {
+        return;
+    }
+
+    for (unsigned long long pieces = men | kings; pieces != 0; pieces = pieces & (pieces - 1)) {
+        int piece_position = __builtin_ctzll(pieces);
+        generate_normal_bit_boards(bit_boards, bit_board, side, (kings >> piece_position) & 1ULL, piece_position);
+    }
+}
+
+void shashki::generate_distinct_bit_boards_for_position(const Position& position,
+                                                        std::vector<BitBoard>& bit_boards)
+{
+    std::vector<CaptureState> visited_states = std::vector<CaptureState>();
+    generate_distinct_bit_boards_for_position(position, bit_boards, visited_states);
+}
+
+void shashki::generate_distinct_bit_boards_for_position(const Position& position,
+                                                        std::vector<BitBoard>& bit_boards,
+                                                        std::vector<CaptureState>& visited_states)
+{
+    bit_boards.clear();
+    const BitBoard& bit_board = position.bit_board;
+    const Side& side = position.current_turn;
+
+    unsigned long long men = bit_board.pieces_of_side_and_type(side, PieceType::MAN);
+    unsigned long long kings = bit_board.pieces_of_side_and_type(side, PieceType::KING);
+
+    for (unsigned long long pieces = men | kings; pieces != 0; pieces = pieces & (pieces - 1)) {
+        int piece_position = __builtin_ctzll(pieces);
+        visited_states.clear();
+
+        walk_capture_paths(bit_board, side, (kings >> piece_position) & 1ULL, piece_position, &visited_states,
+                           [&](const BitBoard& target_bit_board, int target_position) {
+                               // A path that ends where it started could be the same as the one of another piece.
+                               if (target_position != piece_position
+                                   || std::find(bit_boards.begin(), bit_boards.end(), target_bit_board) == bit_boards.end()) {
+                                   bit_boards.push_back(target_bit_board);
+                               }
+                           });
+    }
+
+    // Normal moves are always distinct.
+
+    if (!bit_boards.empty()) {
+        return;
+    }
+
+    for (unsigned long long pieces = men | kings; pieces != 0; pieces = pieces & (pieces - 1)) {
+        int piece_position = __builtin_ctzll(pieces);
+        generate_normal_bit_boards(bit_boards, bit_board, side, (kings >> piece_position) & 1ULL, piece_position);
+    }
+}
+
+unsigned long long shashki::count_move_paths(const Position& position)
+{
+    const BitBoard& bit_board = position.bit_board;
+    const Side& side = position.current_turn;
+
+    unsigned long long men = bit_board.pieces_of_side_and_type(side, PieceType::MAN);
+    unsigned long long kings = bit_board.pieces_of_side_and_type(side, PieceType::KING);
+    unsigned long long paths = 0;
+
+    for (unsigned long long pieces = men | kings; pieces != 0; pieces = pieces & (pieces - 1)) {
+        int piece_position = __builtin_ctzll(pieces);
+        paths += walk_capture_paths(bit_board, side, (kings >> piece_position) & 1ULL, piece_position, NULL,
+                                    [](const BitBoard&, int) {});
+    }
+
+    if (paths > 0) {
+        return paths;
+    }
+
+    // Every normal move results into one BitBoard, so they are counted on whole BitBoards:
+    // the Men step forward once, the Kings slide until they are blocked.
+    unsigned long long empty_bit_board = ~bit_board.blocking_board();
+
+    for (const MoveDirection* move_direction : MOVE_DIRECTIONS) {
+        if ((move_direction->vertical_direction == Direction::UP) == (side == Side::WHITE)) {
+            paths += __builtin_popcountll(shift_bits(men & ~move_direction->normal_wall, *move_direction) & empty_bit_board);
+        }
+
+        for (unsigned long long sliding_bit_board = kings; sliding_bit_board != 0; ) {
+            sliding_bit_board = shift_bits(sliding_bit_board & ~move_direction->normal_wall, *move_direction) & empty_bit_board;
+            paths += __builtin_popcountll(sliding_bit_board);
+        }
+    }
+
+    return paths;
+}
+
+std::vector<shashki::BitBoard> shashki::generate_attack_bit_boards_for_piece(const BitBoard& bit_board,
+                                                                            const Piece& piece)
+{
+    std::vector<BitBoard> bit_boards = std::vector<BitBoard>();
+    generate_attack_bit_boards_for_piece(bit_board, piece, bit_boards);
+    return bit_boards;
+}
+
+void shashki::generate_attack_bit_boards_for_piece(const BitBoard& bit_board,
+                                                   const Piece& piece,
+                                                   std::vector<BitBoard>& bit_boards)
+{
+    bit_boards.clear();
+    generate_capture_bit_boards(bit_boards, bit_board, piece.side, piece.piece_type == PieceType::KING, piece.position);
+}
+
+std::vector<shashki::BitBoard> shashki::generate_normal_bit_boards_for_piece(const BitBoard& bit_board,
+                                                                            const Piece& piece)
+{
+    std::vector<BitBoard> bit_boards = std::vector<BitBoard>();
+    generate_normal_bit_boards_for_piece(bit_board, piece, bit_boards);
+    return bit_boards;
+}
+
+void shashki::generate_normal_bit_boards_for_piece(const BitBoard& bit_board,
+                                                   const Piece& piece,
+                                                   std::vector<BitBoard>& bit_boards)
+{
+    bit_boards.clear();
+    generate_normal_bit_boards(bit_boards, bit_board, piece.side, piece.piece_type == PieceType::KING, piece.position);
+}
+
+bool shashki::side_can_capture(const BitBoard& bit_board,
+                               const Side& side)
+{
+    unsigned long long men = bit_board.pieces_of_side_and_type(side, PieceType::MAN);
+    unsigned long long kings = bit_board.pieces_of_side_and_type(side, PieceType::KING);
+    unsigned long long enemy_bit_board = bit_board.blocking_board_of_side(side_opposite(side));
+    unsigned long long empty_bit_board = ~bit_board.blocking_board();
+
+    for (const MoveDirection* move_direction : MOVE_DIRECTIONS) {
+        // Kings can move over several empty positions before the attack,
+        // so every position they can slide to is an attacking position as well.
+        unsigned long long attacking_bit_board = men | kings;
+        unsigned long long sliding_bit_board = kings;
+
+        while (sliding_bit_board != 0) {
+            sliding_bit_board = shift_bits(sliding_bit_board & ~move_direction->normal_wall, *move_direction) & empty_bit_board;
+            attacking_bit_board = attacking_bit_board | sliding_bit_board;
+        }
+
+        // An attack needs an opponents piece next to the attacking position and an empty position behind it.
+        unsigned long long attacked_bit_board = shift_bits(attacking_bit_board & ~move_direction->attack_wall, *move_direction) & enemy_bit_board;
+
+        if (shift_bits(attacked_bit_board, *move_direction) & empty_bit_board) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 // Implementation of the helper functions:
 
 /**
@@ -575,3 +792,229 @@ void follow_move_after_enemy(shashki::Move& move,
         follow_move_after_enemy(move, move_direction, capture_bit_board, move_bit_board, move_count + 1, attack_count + 1);
     }
 }
+
+/**
+ * Returns a copy of the BitBoard where the piece of the given side is moved from
+ * the source_position to the target_position (as King if king is true) and the
+ * attacked_bit (which may be 0 if nothing is jumped) is removed.
+ * This is the same alteration the Move constructor does for its target_bit_board.
+ */
+shashki::BitBoard bit_board_after_step(const shashki::BitBoard& bit_board,
+                                       const shashki::Side& side,
+                                       bool king,
+                                       int source_position,
+                                       int target_position,
+                                       unsigned long long attacked_bit)
+{
+    unsigned long long removed_bits = ~((1ULL << source_position) | attacked_bit);
+    shashki::BitBoard target_bit_board = shashki::BitBoard(bit_board.white_men & removed_bits,
+                                                           bit_board.white_kings & removed_bits,
+                                                           bit_board.black_men & removed_bits,
+                                                           bit_board.black_kings & removed_bits);
+
+    if (side == shashki::Side::WHITE && king) {
+        target_bit_board.white_kings = target_bit_board.white_kings | (1ULL << target_position);
+    } else if (side == shashki::Side::WHITE) {
+        target_bit_board.white_men = target_bit_board.white_men | (1ULL << target_position);
+    } else if (king) {
+        target_bit_board.black_kings = target_bit_board.black_kings | (1ULL << target_position);
+    } else {
+        target_bit_board.black_men = target_bit_board.black_men | (1ULL << target_position);
+    }
+
+    return target_bit_board;
+}
+
+/**
+ * Returns true if the state (the piece on the position, as King or not, after jumping the pieces
+ * of the capture_bit_board) has not been visited before and adds it to the visited_states.
+ * The state alone decides which jumps follow, so every state only needs to be walked once.
+ */
+bool visit_capture_state(std::vector<shashki::CaptureState>& visited_states,
+                         int position,
+                         bool king,
+                         unsigned long long capture_bit_board)
+{
+    shashki::CaptureState capture_state = shashki::CaptureState{capture_bit_board, position | (king ? 64 : 0)};
+
+    for (const shashki::CaptureState& visited_state : visited_states) {
+        if (visited_state.capture_bit_board == capture_state.capture_bit_board && visited_state.piece == capture_state.piece) {
+            return false;
+        }
+    }
+
+    visited_states.push_back(capture_state);
+    return true;
+}
+
+/**
+ * Walks every attack path of the piece on the given position and calls visit_path with the
+ * resulting BitBoard and the final position of the piece at the end of every path.
+ * Returns the number of visited paths.
+ * It walks the same way as "move_before_enemy()" / "move_after_enemy()" and their follow move
+ * counterparts do, but square by square for the one piece instead of whole move_bit_boards.
+ * A Man that gets promoted during the path continues as a King.
+ * Instead of recursion (or a tree of follow moves) there is one CaptureFrame per jump of the
+ * current path on a fixed size stack, so the memory stays the same however many paths there are.
+ * The frames only hold the jumped pieces and the position, the BitBoard is only built at the end of a path.
+ * If visited_states is given, every state is only walked once: paths that reach an already
+ * visited state are cut off, so every resulting BitBoard is only visited once.
+ */
+template <typename PathVisitor>
+unsigned long long walk_capture_paths(const shashki::BitBoard& bit_board,
+                                      const shashki::Side& side,
+                                      bool king,
+                                      int position,
+                                      std::vector<shashki::CaptureState>* visited_states,
+                                      PathVisitor&& visit_path)
+{
+    CaptureFrame frames[MAX_CAPTURE_PATH_LENGTH + 1];
+    frames[0] = CaptureFrame{0ULL, position, king, -1, 0, 0, false, false};
+
+    // The jumped pieces are removed from the board right away, the piece itself is where the frame says.
+    unsigned long long enemy_bit_board = bit_board.blocking_board_of_side(shashki::side_opposite(side));
+    unsigned long long other_bit_board = bit_board.blocking_board() & ~(1ULL << position);
+    unsigned long long paths = 0;
+    int depth = 0;
+
+    while (depth >= 0) {
+        CaptureFrame& frame = frames[depth];
+        unsigned long long blocking_bit_board = (other_bit_board & ~frame.capture_bit_board) | (1ULL << frame.position);
+
+        // 1. Move towards the opponents piece into the next direction (several positions for Kings).
+        if (!frame.landing) {
+            frame.direction++;
+
+            // All directions are done: without any jump from here this is the end of a path.
+            if (frame.direction == 4) {
+                if (depth > 0 && !frame.jumped) {
+                    visit_path(bit_board_after_step(bit_board, side, frame.king, position, frame.position, frame.capture_bit_board),
+                               frame.position);
+                    paths++;
+                }
+
+                depth--;
+                continue;
+            }
+
+            const MoveDirection* move_direction = MOVE_DIRECTIONS[frame.direction];
+            int attack_position = frame.position;
+
+            while (!((1ULL << attack_position) & move_direction->attack_wall)) {
+                attack_position += move_direction->position_move;
+                unsigned long long attack_bit = 1ULL << attack_position;
+
+                if (attack_bit & frame.capture_bit_board) {
+                    break;
+                }
+
+                if (attack_bit & enemy_bit_board) {
+                    frame.landing = true;
+                    break;
+                }
+
+                if ((attack_bit & blocking_bit_board) || !frame.king) {
+                    break;
+                }
+            }
+
+            frame.attack_position = attack_position;
+            frame.target_position = attack_position;
+            continue;
+        }
+
+        // 2. Jump over the opponents piece and land on the next free position behind it
+        //    (only the first one for Men) and continue with the follow jumps from there.
+        const MoveDirection* move_direction = MOVE_DIRECTIONS[frame.direction];
+
+        if ((1ULL << frame.target_position) & move_direction->normal_wall) {
+            frame.landing = false;
+            continue;
+        }
+
+        frame.target_position += move_direction->position_move;
+
+        if ((1ULL << frame.target_position) & (blocking_bit_board | frame.capture_bit_board)) {
+            frame.landing = false;
+            continue;
+        }
+
+        bool promotion = !frame.king && (side == shashki::Side::WHITE ? frame.target_position > 55 : frame.target_position < 8);
+        unsigned long long capture_bit_board = frame.capture_bit_board | (1ULL << frame.attack_position);
+
+        frame.jumped = true;
+        frame.landing = frame.king;
+
+        if (visited_states != NULL
+            && !visit_capture_state(*visited_states, frame.target_position, frame.king || promotion, capture_bit_board)) {
+            continue;
+        }
+
+        frames[depth + 1] = CaptureFrame{capture_bit_board, frame.target_position, frame.king || promotion, -1, 0, 0, false, false};
+        depth++;
+    }
+
+    return paths;
+}
+
+/**
+ * Adds the resulting BitBoard of every attack path of the piece on the given position
+ * to bit_boards and returns the number of added paths.
+ */
+int generate_capture_bit_boards(std::vector<shashki::BitBoard>& bit_boards,
+                                const shashki::BitBoard& bit_board,
+                                const shashki::Side& side,
+                                bool king,
+                                int position)
+{
+    return walk_capture_paths(bit_board, side, king, position, NULL,
+                              [&](const shashki::BitBoard& target_bit_board, int) { bit_boards.push_back(target_bit_board); });
+}
+
+/**
+ * Adds the resulting BitBoard of every normal move of the piece on the given position
+ * to bit_boards. Men only move forward by one position, Kings move over several positions
+ * in all directions until they are blocked.
+ */
+void generate_normal_bit_boards(std::vector<shashki::BitBoard>& bit_boards,
+                                const shashki::BitBoard& bit_board,
+                                const shashki::Side& side,
+                                bool king,
+                                int position)
+{
+    unsigned long long blocking_bit_board = bit_board.blocking_board();
+
+    for (const MoveDirection* move_direction : MOVE_DIRECTIONS) {
+        if (!king && (move_direction->vertical_direction == Direction::UP) != (side == shashki::Side::WHITE)) {
+            continue;
+        }
+
+        int target_position = position;
+
+        while (!((1ULL << target_position) & move_direction->normal_wall)) {
+            target_position += move_direction->position_move;
+
+            if ((1ULL << target_position) & blocking_bit_board) {
+                break;
+            }
+
+            bool promotion = !king && move_direction->promotion_check(side, shashki::PieceType::MAN, target_position);
+            bit_boards.push_back(bit_board_after_step(bit_board, side, king || promotion, position, target_position, 0ULL));
+
+            if (!king) {
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Moves all the bits one position into the diagonal direction of the MoveDirection.
+ * This is the same as the bit_operation of the MoveDirection without the indirection
+ * of a function object.
+ */
+unsigned long long shift_bits(unsigned long long bits,
+                              const MoveDirection& move_direction)
+{
+    return move_direction.position_move > 0 ? bits << move_direction.position_move : bits >> -move_direction.position_move;
+}
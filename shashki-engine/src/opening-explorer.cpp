@@ -0,0 +1,447 @@
+#include "shashki-engine/opening-explorer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "shashki-engine/zobrist.hpp"
+#include "internal.hpp"
+
+// Layout of an opening tree file:
+//
+// OpeningTreeHeader
+// OpeningTreeEntry[entry_count]                 (sorted by key)
+// OpeningTreeContinuation[continuation_count]   (grouped by entry, most common first)
+//
+// All the structures are naturally aligned and stored in the byte order of the machine.
+
+const char OPENING_TREE_MAGIC[8] = {'S', 'H', 'O', 'P', 'E', 'N', 'T', 'R'};
+const std::uint32_t OPENING_TREE_VERSION = 2;
+
+struct OpeningTreeHeader
+{
+    char            magic[8];
+    std::uint32_t   version;
+    std::uint32_t   max_plies;
+    std::uint64_t   entry_count;
+    std::uint64_t   continuation_count;
+};
+
+struct OpeningTreeEntry
+{
+    std::uint64_t   key;
+    std::uint32_t   games;
+    std::uint32_t   white_wins;
+    std::uint32_t   draws;
+    std::uint32_t   black_wins;
+    std::uint32_t   first_continuation;
+    std::uint32_t   continuation_count;
+};
+
+struct OpeningTreeContinuation
+{
+    std::uint64_t   captures;
+    std::uint16_t   squares;
+    std::uint16_t   reserved;
+    std::uint32_t   games;
+};
+
+/**
+ * The aggregates of one position while building an opening tree.
+ */
+struct OpeningAggregate
+{
+    unsigned int                                games = 0;
+    unsigned int                                white_wins = 0;
+    unsigned int                                draws = 0;
+    unsigned int                                black_wins = 0;
+    std::vector<shashki::OpeningContinuation>   continuations;
+};
+
+using OpeningAggregates = std::unordered_map<unsigned long long, OpeningAggregate>;
+
+/**
+ * The number of GameRecords a thread takes at once in the map phase.
+ */
+const std::size_t AGGREGATION_CHUNK_SIZE = 256;
+
+/**
+ * Returns the header of an opening tree file in memory
+ * or NULL if the data is no complete opening tree file.
+ * The continuations of every entry are checked to lie within the file,
+ * so the entries can be followed without any further bounds checks.
+ */
+const OpeningTreeHeader* opening_tree_header(const unsigned char* data,
+                                             std::size_t size)
+{
+    if (size < sizeof(OpeningTreeHeader)) {
+        return NULL;
+    }
+
+    const OpeningTreeHeader* header = reinterpret_cast<const OpeningTreeHeader*>(data);
+    std::size_t body_size = size - sizeof(OpeningTreeHeader);
+
+    // The counts are compared against the size first, so that the products cannot overflow.
+    if (std::memcmp(header->magic, OPENING_TREE_MAGIC, sizeof(OPENING_TREE_MAGIC)) != 0
+        || header->version != OPENING_TREE_VERSION
+        || header->entry_count > body_size / sizeof(OpeningTreeEntry)
+        || header->continuation_count > body_size / sizeof(OpeningTreeContinuation)
+        || body_size != header->entry_count * sizeof(OpeningTreeEntry)
+                        + header->continuation_count * sizeof(OpeningTreeContinuation)) {
+        return NULL;
+    }
+
+    const OpeningTreeEntry* entries = reinterpret_cast<const OpeningTreeEntry*>(data + sizeof(OpeningTreeHeader));
+
+    for (std::uint64_t index = 0; index < header->entry_count; index++) {
+        if ((std::uint64_t) entries[index].first_continuation + entries[index].continuation_count > header->continuation_count) {
+            return NULL;
+        }
+    }
+
+    return header;
+}
+
+/**
+ * Adds games to the continuation of the given move (a new continuation is created if necessary).
+ */
+void add_continuation(OpeningAggregate& aggregate,
+                      const shashki::PackedMove& move,
+                      unsigned int games)
+{
+    for (shashki::OpeningContinuation& continuation : aggregate.continuations) {
+        if (continuation.move == move) {
+            continuation.games += games;
+            return;
+        }
+    }
+
+    aggregate.continuations.push_back(shashki::OpeningContinuation{move, games});
+}
+
+/**
+ * Adds all the aggregates of one position to the aggregates of the same position (reduce step).
+ */
+void merge_aggregate(OpeningAggregate& aggregate,
+                     const OpeningAggregate& other_aggregate)
+{
+    aggregate.games += other_aggregate.games;
+    aggregate.white_wins += other_aggregate.white_wins;
+    aggregate.draws += other_aggregate.draws;
+    aggregate.black_wins += other_aggregate.black_wins;
+
+    for (const shashki::OpeningContinuation& continuation : other_aggregate.continuations) {
+        add_continuation(aggregate, continuation.move, continuation.games);
+    }
+}
+
+/**
+ * Counts the game in the aggregate of the position with the given key and returns the aggregate
+ * or NULL if the position has already been counted for this game (game_keys).
+ */
+OpeningAggregate* count_position(OpeningAggregates& aggregates,
+                                 std::vector<unsigned long long>& game_keys,
+                                 unsigned long long key,
+                                 shashki::GameResult result)
+{
+    if (std::find(game_keys.begin(), game_keys.end(), key) != game_keys.end()) {
+        return NULL;
+    }
+
+    game_keys.push_back(key);
+
+    OpeningAggregate& aggregate = aggregates[key];
+    aggregate.games++;
+    aggregate.white_wins += result == shashki::GameResult::WHITE_WIN ? 1 : 0;
+    aggregate.draws += result == shashki::GameResult::DRAW ? 1 : 0;
+    aggregate.black_wins += result == shashki::GameResult::BLACK_WIN ? 1 : 0;
+
+    return &aggregate;
+}
+
+/**
+ * Replays one GameRecord and aggregates the positions of its first max_plies plies (map step).
+ * The position reached after the last replayed ply is counted as well, without a continuation,
+ * so that the final positions of short games can be found too.
+ * A position that repeats within the same game is only counted once.
+ */
+void aggregate_game_record(OpeningAggregates& aggregates,
+                           const shashki::GameRecord& game_record,
+                           int max_plies)
+{
+    shashki::Position position = game_record.start_position;
+    std::vector<unsigned long long> game_keys = std::vector<unsigned long long>();
+    std::size_t plies = std::min(game_record.moves.size(), (std::size_t) std::max(max_plies, 0));
+
+    for (std::size_t ply = 0; ply < plies; ply++) {
+        unsigned long long key = shashki::zobrist_hash(position);
+
+        // The position before an illegal ply is left untouched and counted as the last one below.
+        if (!shashki::execute_packed_move(position, game_record.moves[ply])) {
+            break;
+        }
+
+        OpeningAggregate* aggregate = count_position(aggregates, game_keys, key, game_record.result);
+
+        if (aggregate != NULL) {
+            add_continuation(*aggregate, game_record.moves[ply], 1);
+        }
+    }
+
+    count_position(aggregates, game_keys, shashki::zobrist_hash(position), game_record.result);
+}
+
+/**
+ * The parallel map-reduce over the GameRecords. Every thread maps its chunks
+ * of games into its own aggregates, which are reduced into one at the end.
+ */
+OpeningAggregates aggregate_game_records(const std::vector<shashki::GameRecord>& game_records,
+                                         int max_plies,
+                                         unsigned int thread_count)
+{
+    std::vector<OpeningAggregates> thread_aggregates = std::vector<OpeningAggregates>(std::max(thread_count, 1U));
+
+    process_in_chunks(game_records.size(), AGGREGATION_CHUNK_SIZE, thread_count,
+                      [&](unsigned int thread_index, std::size_t first, std::size_t last) {
+        for (std::size_t index = first; index < last; index++) {
+            aggregate_game_record(thread_aggregates[thread_index], game_records[index], max_plies);
+        }
+    });
+
+    for (std::size_t index = 1; index < thread_aggregates.size(); index++) {
+        for (const std::pair<const unsigned long long, OpeningAggregate>& entry : thread_aggregates[index]) {
+            merge_aggregate(thread_aggregates[0][entry.first], entry.second);
+        }
+    }
+
+    return std::move(thread_aggregates[0]);
+}
+
+/**
+ * Reads an existing opening tree file back into aggregates. Throws std::runtime_error
+ * if the file has been built with another max_plies, as its aggregates would not fit.
+ */
+void load_opening_tree(const std::string& path,
+                       int max_plies,
+                       OpeningAggregates& aggregates)
+{
+    std::ifstream file = std::ifstream(path, std::ios::binary);
+
+    if (!file) {
+        throw std::runtime_error("Cannot read opening tree file: " + path);
+    }
+
+    std::vector<unsigned char> data = std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    if (file.bad()) {
+        throw std::runtime_error("Cannot read opening tree file: " + path);
+    }
+
+    const OpeningTreeHeader* header = opening_tree_header(data.data(), data.size());
+
+    if (header == NULL) {
+        throw std::runtime_error("Invalid opening tree file: " + path);
+    }
+
+    if (header->max_plies != (std::uint32_t) std::max(max_plies, 0)) {
+        throw std::runtime_error("Opening tree file built with " + std::to_string(header->max_plies)
+                                 + " instead of " + std::to_string(max_plies) + " plies: " + path);
+    }
+
+    const OpeningTreeEntry* entries = reinterpret_cast<const OpeningTreeEntry*>(data.data() + sizeof(OpeningTreeHeader));
+    const OpeningTreeContinuation* continuations = reinterpret_cast<const OpeningTreeContinuation*>(entries + header->entry_count);
+
+    for (std::uint64_t index = 0; index < header->entry_count; index++) {
+        const OpeningTreeEntry& entry = entries[index];
+        OpeningAggregate aggregate = OpeningAggregate();
+
+        aggregate.games = entry.games;
+        aggregate.white_wins = entry.white_wins;
+        aggregate.draws = entry.draws;
+        aggregate.black_wins = entry.black_wins;
+
+        for (std::uint32_t offset = 0; offset < entry.continuation_count; offset++) {
+            const OpeningTreeContinuation& continuation = continuations[entry.first_continuation + offset];
+            shashki::PackedMove move = shashki::PackedMove(continuation.squares & 0b111111, continuation.squares >> 6, continuation.captures);
+            aggregate.continuations.push_back(shashki::OpeningContinuation{move, continuation.games});
+        }
+
+        merge_aggregate(aggregates[entry.key], aggregate);
+    }
+}
+
+/**
+ * Writes the aggregates as opening tree file. The file is written next to the
+ * target path first and then renamed, so readers never see a half written file.
+ */
+void write_opening_tree(const std::string& path,
+                        int max_plies,
+                        OpeningAggregates& aggregates)
+{
+    std::vector<unsigned long long> keys = std::vector<unsigned long long>();
+    std::uint64_t continuation_count = 0;
+
+    for (std::pair<const unsigned long long, OpeningAggregate>& entry : aggregates) {
+        keys.push_back(entry.first);
+        continuation_count += entry.second.continuations.size();
+
+        std::sort(entry.second.continuations.begin(), entry.second.continuations.end(),
+                  [](const shashki::OpeningContinuation& first, const shashki::OpeningContinuation& second) {
+            if (first.games != second.games) {
+                return first.games > second.games;
+            }
+
+            // Flying Kings can reach the same square by jumping different pieces,
+            // so the captures decide last and the order never depends on the merge order.
+            return first.move.squares != second.move.squares ? first.move.squares < second.move.squares
+                                                             : first.move.captures < second.move.captures;
+        });
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    OpeningTreeHeader header = OpeningTreeHeader();
+    std::memcpy(header.magic, OPENING_TREE_MAGIC, sizeof(OPENING_TREE_MAGIC));
+    header.version = OPENING_TREE_VERSION;
+    header.max_plies = (std::uint32_t) std::max(max_plies, 0);
+    header.entry_count = keys.size();
+    header.continuation_count = continuation_count;
+
+    std::vector<OpeningTreeEntry> entries = std::vector<OpeningTreeEntry>();
+    std::vector<OpeningTreeContinuation> continuations = std::vector<OpeningTreeContinuation>();
+
+    for (unsigned long long key : keys) {
+        const OpeningAggregate& aggregate = aggregates[key];
+
+        entries.push_back(OpeningTreeEntry{key, aggregate.games, aggregate.white_wins, aggregate.draws, aggregate.black_wins,
+                                           (std::uint32_t) continuations.size(), (std::uint32_t) aggregate.continuations.size()});
+
+        for (const shashki::OpeningContinuation& continuation : aggregate.continuations) {
+            continuations.push_back(OpeningTreeContinuation{continuation.move.captures, continuation.move.squares, 0, continuation.games});
+        }
+    }
+
+    std::string temporary_path = path + ".tmp";
+    std::ofstream file = std::ofstream(temporary_path, std::ios::binary | std::ios::trunc);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(OpeningTreeEntry));
+    file.write(reinterpret_cast<const char*>(continuations.data()), continuations.size() * sizeof(OpeningTreeContinuation));
+    file.close();
+
+    if (!file || std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+        std::remove(temporary_path.c_str());
+        throw std::runtime_error("Cannot write opening tree file: " + path);
+    }
+}
+
+void shashki::build_opening_tree(const std::string& path,
+                                 const std::vector<GameRecord>& game_records,
+                                 int max_plies,
+                                 unsigned int thread_count)
+{
+    OpeningAggregates aggregates = aggregate_game_records(game_records, max_plies, thread_count);
+    write_opening_tree(path, max_plies, aggregates);
+}
+
+void shashki::update_opening_tree(const std::string& path,
+                                  const std::vector<GameRecord>& game_records,
+                                  int max_plies,
+                                  unsigned int thread_count)
+{
+    OpeningAggregates aggregates = aggregate_game_records(game_records, max_plies, thread_count);
+
+    // Only a missing file starts a new tree, a file that cannot be read must not be replaced.
+    struct stat file_status;
+
+    if (stat(path.c_str(), &file_status) == 0 || errno != ENOENT) {
+        load_opening_tree(path, max_plies, aggregates);
+    }
+
+    write_opening_tree(path, max_plies, aggregates);
+}
+
+shashki::OpeningTree::OpeningTree(const std::string& path)
+    : data(NULL),
+      size(0)
+{
+    int file_descriptor = open(path.c_str(), O_RDONLY);
+    struct stat file_status;
+
+    if (file_descriptor < 0 || fstat(file_descriptor, &file_status) != 0) {
+        if (file_descriptor >= 0) {
+            close(file_descriptor);
+        }
+
+        throw std::runtime_error("Cannot open opening tree file: " + path);
+    }
+
+    void* mapping = file_status.st_size > 0
+        ? mmap(NULL, file_status.st_size, PROT_READ, MAP_SHARED, file_descriptor, 0)
+        : MAP_FAILED;
+
+    // The mapping stays valid after closing the file descriptor.
+    close(file_descriptor);
+
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map opening tree file: " + path);
+    }
+
+    if (opening_tree_header(static_cast<const unsigned char*>(mapping), file_status.st_size) == NULL) {
+        munmap(mapping, file_status.st_size);
+        throw std::runtime_error("Invalid opening tree file: " + path);
+    }
+
+    this->data = static_cast<const unsigned char*>(mapping);
+    this->size = file_status.st_size;
+}
+
+shashki::OpeningTree::~OpeningTree()
+{
+    munmap(const_cast<unsigned char*>(this->data), this->size);
+}
+
+std::optional<shashki::OpeningStatistics> shashki::OpeningTree::find(const Position& position,
+                                                                     std::size_t max_continuations) const
+{
+    const OpeningTreeHeader* header = reinterpret_cast<const OpeningTreeHeader*>(this->data);
+    const OpeningTreeEntry* entries = reinterpret_cast<const OpeningTreeEntry*>(this->data + sizeof(OpeningTreeHeader));
+    const OpeningTreeContinuation* continuations = reinterpret_cast<const OpeningTreeContinuation*>(entries + header->entry_count);
+    unsigned long long key = zobrist_hash(position);
+
+    const OpeningTreeEntry* entry = std::lower_bound(entries, entries + header->entry_count, key,
+                                                     [](const OpeningTreeEntry& entry, unsigned long long key) {
+        return entry.key < key;
+    });
+
+    if (entry == entries + header->entry_count || entry->key != key) {
+        return std::optional<OpeningStatistics>();
+    }
+
+    OpeningStatistics statistics = OpeningStatistics{entry->games, entry->white_wins, entry->draws, entry->black_wins,
+                                                     std::vector<OpeningContinuation>()};
+    std::size_t continuation_count = std::min((std::size_t) entry->continuation_count, max_continuations);
+
+    for (std::size_t offset = 0; offset < continuation_count; offset++) {
+        const OpeningTreeContinuation& continuation = continuations[entry->first_continuation + offset];
+        PackedMove move = PackedMove(continuation.squares & 0b111111, continuation.squares >> 6, continuation.captures);
+        statistics.continuations.push_back(OpeningContinuation{move, continuation.games});
+    }
+
+    return statistics;
+}
+
+std::size_t shashki::OpeningTree::position_count() const
+{
+    return reinterpret_cast<const OpeningTreeHeader*>(this->data)->entry_count;
+}
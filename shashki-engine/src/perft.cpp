@@ -0,0 +1,246 @@
+#include "shashki-engine/perft.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "shashki-engine/move-generation.hpp"
+#include "internal.hpp"
+
+/**
+ * A PerftHashEntry caches the leaf count of one subtree.
+ * It is written and read by several threads without locking. To detect
+ * torn entries the check member does not hold the key directly but the key
+ * XOR the nodes. An entry only counts as a hit if both members fit together.
+ */
+struct PerftHashEntry
+{
+    std::atomic<unsigned long long> check;
+    std::atomic<unsigned long long> nodes;
+};
+
+/**
+ * The PerftHashTable is a fixed size table of PerftHashEntries
+ * which is shared by all the threads of one "fast_perft()" run.
+ * Newer entries always replace older ones.
+ */
+class PerftHashTable
+{
+    private:
+
+    std::unique_ptr<PerftHashEntry[]>   entries;
+    std::size_t                         mask;
+
+    public:
+
+    /**
+     * Constructs an empty table with the given number of entries
+     * rounded down to a power of two.
+     */
+    PerftHashTable(std::size_t entry_count)
+        : entries(),
+          mask(0)
+    {
+        std::size_t size = power_of_two_floor(entry_count);
+
+        this->entries = std::unique_ptr<PerftHashEntry[]>(new PerftHashEntry[size]);
+        this->mask = size - 1;
+
+        for (std::size_t index = 0; index < size; index++) {
+            this->entries[index].check.store(0, std::memory_order_relaxed);
+            this->entries[index].nodes.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Returns true and writes the cached leaf count into nodes
+     * if there is an entry for the given key.
+     */
+    bool probe(unsigned long long key, unsigned long long& nodes) const
+    {
+        const PerftHashEntry& entry = this->entries[key & this->mask];
+        unsigned long long entry_nodes = entry.nodes.load(std::memory_order_relaxed);
+        unsigned long long entry_check = entry.check.load(std::memory_order_relaxed);
+
+        if ((entry_check ^ entry_nodes) != key || entry_nodes == 0) {
+            return false;
+        }
+
+        nodes = entry_nodes;
+        return true;
+    }
+
+    /**
+     * Stores the leaf count for the given key.
+     */
+    void store(unsigned long long key, unsigned long long nodes)
+    {
+        PerftHashEntry& entry = this->entries[key & this->mask];
+        entry.nodes.store(nodes, std::memory_order_relaxed);
+        entry.check.store(key ^ nodes, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Mixes the bits of a 64-bit integer (finalizer of splitmix64)
+ * so that similar BitBoards end up in different places of the hash table.
+ */
+unsigned long long mix_bits(unsigned long long bits)
+{
+    bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    bits = (bits ^ (bits >> 27)) * 0x94d049bb133111ebULL;
+    return bits ^ (bits >> 31);
+}
+
+/**
+ * Calculates the key of the hash table for a subtree,
+ * which is identified by the BitBoard, the side to move and the remaining depth.
+ */
+unsigned long long perft_hash_key(const shashki::BitBoard& bit_board,
+                                  shashki::Side side,
+                                  int depth)
+{
+    unsigned long long key = mix_bits(bit_board.white_men);
+    key = mix_bits(key ^ bit_board.white_kings);
+    key = mix_bits(key ^ bit_board.black_men);
+    key = mix_bits(key ^ bit_board.black_kings);
+    key = mix_bits(key ^ ((unsigned long long) depth << 1) ^ (side == shashki::Side::BLACK ? 1ULL : 0ULL));
+
+    return key;
+}
+
+/**
+ * Collects the resulting BitBoard of every move path of a move.
+ * This is the same conversion the engine does for building its child nodes.
+ */
+void collect_move_path_bit_boards(std::vector<shashki::BitBoard>& bit_boards,
+                                  const shashki::Move& move)
+{
+    if (move.get_follow_moves().empty()) {
+        bit_boards.push_back(move.get_target_bit_board());
+    } else {
+        for (const shashki::Move& follow_move : move.get_follow_moves()) {
+            collect_move_path_bit_boards(bit_boards, follow_move);
+        }
+    }
+}
+
+/**
+ * Collects the resulting BitBoards of all the legal move paths for the given side.
+ */
+std::vector<shashki::BitBoard> generate_child_bit_boards(const shashki::BitBoard& bit_board,
+                                                         shashki::Side side)
+{
+    std::vector<shashki::BitBoard> child_bit_boards = std::vector<shashki::BitBoard>();
+
+    for (const shashki::Move& move : shashki::generate_moves_for_side(bit_board, side)) {
+        collect_move_path_bit_boards(child_bit_boards, move);
+    }
+
+    return child_bit_boards;
+}
+
+/**
+ * The plain recursive perft which makes every single move.
+ */
+unsigned long long perft_recursive(const shashki::BitBoard& bit_board,
+                                   shashki::Side side,
+                                   int depth)
+{
+    if (depth <= 0) {
+        return 1;
+    }
+
+    unsigned long long nodes = 0;
+
+    for (const shashki::BitBoard& child_bit_board : generate_child_bit_boards(bit_board, side)) {
+        nodes += perft_recursive(child_bit_board, shashki::side_opposite(side), depth - 1);
+    }
+
+    return nodes;
+}
+
+/**
+ * The optimised recursive perft. It shall only be called with a depth of at least 1.
+ * It uses the fast BitBoard generator instead of building Move objects.
+ * On the last ply the move paths are only counted, not recursed into.
+ * Above the last ply the hash table (if there is one) is consulted first.
+ * ply_bit_boards holds one reused list per remaining depth (at least depth + 1 lists),
+ * so that no node allocates its own.
+ */
+unsigned long long fast_perft_recursive(const shashki::BitBoard& bit_board,
+                                        shashki::Side side,
+                                        int depth,
+                                        PerftHashTable* hash_table,
+                                        std::vector<std::vector<shashki::BitBoard>>& ply_bit_boards)
+{
+    if (depth == 1) {
+        return shashki::count_move_paths(shashki::Position(bit_board, side));
+    }
+
+    unsigned long long key = perft_hash_key(bit_board, side, depth);
+    unsigned long long nodes = 0;
+
+    if (hash_table != NULL && hash_table->probe(key, nodes)) {
+        return nodes;
+    }
+
+    std::vector<shashki::BitBoard>& bit_boards = ply_bit_boards[depth];
+    shashki::generate_bit_boards_for_position(shashki::Position(bit_board, side), bit_boards);
+
+    for (const shashki::BitBoard& child_bit_board : bit_boards) {
+        nodes += fast_perft_recursive(child_bit_board, shashki::side_opposite(side), depth - 1, hash_table, ply_bit_boards);
+    }
+
+    if (hash_table != NULL) {
+        hash_table->store(key, nodes);
+    }
+
+    return nodes;
+}
+
+unsigned long long shashki::perft(const Position& position,
+                                  int depth)
+{
+    return perft_recursive(position.bit_board, position.current_turn, depth);
+}
+
+shashki::PerftResult shashki::fast_perft(const Position& position,
+                                         int depth,
+                                         unsigned int thread_count,
+                                         std::size_t hash_entries)
+{
+    std::chrono::duration before_perft = std::chrono::high_resolution_clock::now().time_since_epoch();
+
+    std::unique_ptr<PerftHashTable> hash_table = hash_entries > 0
+        ? std::unique_ptr<PerftHashTable>(new PerftHashTable(hash_entries))
+        : std::unique_ptr<PerftHashTable>();
+
+    unsigned long long nodes = 0;
+
+    if (depth <= 1) {
+        nodes = depth <= 0 ? 1 : count_move_paths(position);
+    } else {
+        // Split the root: every thread takes the next unprocessed root child until none is left.
+        std::vector<BitBoard> root_bit_boards = generate_bit_boards_for_position(position);
+        std::vector<std::vector<std::vector<BitBoard>>> thread_ply_bit_boards = std::vector<std::vector<std::vector<BitBoard>>>(
+            std::max(thread_count, 1U), std::vector<std::vector<BitBoard>>(depth));
+        std::atomic<unsigned long long> total_nodes = 0;
+
+        process_in_chunks(root_bit_boards.size(), 1, thread_count,
+                          [&](unsigned int thread_index, std::size_t first, std::size_t last) {
+            for (std::size_t index = first; index < last; index++) {
+                total_nodes += fast_perft_recursive(root_bit_boards[index], side_opposite(position.current_turn),
+                                                    depth - 1, hash_table.get(), thread_ply_bit_boards[thread_index]);
+            }
+        });
+
+        nodes = total_nodes;
+    }
+
+    std::chrono::duration after_perft = std::chrono::high_resolution_clock::now().time_since_epoch();
+    unsigned long long millis = std::chrono::duration_cast<std::chrono::milliseconds>(after_perft - before_perft).count();
+
+    return PerftResult{nodes, millis, nodes * 1000 / std::max(millis, 1ULL)};
+}
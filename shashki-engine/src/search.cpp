@@ -0,0 +1,417 @@
+#include "shashki-engine/search.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include "shashki-engine/move-generation.hpp"
+#include "shashki-engine/evaluation.hpp"
+#include "shashki-engine/zobrist.hpp"
+#include "internal.hpp"
+
+/**
+ * A score beyond every possible score, used as the initial search window.
+ */
+const int INFINITE_SCORE = shashki::SEARCH_WIN_SCORE + 1;
+
+/**
+ * Scores beyond this one are wins or losses (see SEARCH_WIN_SCORE).
+ */
+const int WIN_BOUND_SCORE = shashki::SEARCH_WIN_SCORE - shashki::MAX_SEARCH_DEPTH - 1;
+
+shashki::TranspositionTable::TranspositionTable(std::size_t entry_count)
+    : entries(),
+      mask(0)
+{
+    std::size_t size = power_of_two_floor(entry_count);
+
+    this->entries = std::unique_ptr<TranspositionEntry[]>(new TranspositionEntry[size]);
+    this->mask = size - 1;
+    this->clear();
+}
+
+void shashki::TranspositionTable::prefetch(unsigned long long key) const
+{
+    __builtin_prefetch(&this->entries[key & this->mask]);
+}
+
+bool shashki::TranspositionTable::probe(unsigned long long key,
+                                        TranspositionEntry& entry) const
+{
+    const TranspositionEntry& table_entry = this->entries[key & this->mask];
+
+    if (table_entry.bound == ScoreBound::NONE || table_entry.key != key) {
+        return false;
+    }
+
+    entry = table_entry;
+    return true;
+}
+
+void shashki::TranspositionTable::store(const TranspositionEntry& entry)
+{
+    TranspositionEntry& table_entry = this->entries[entry.key & this->mask];
+
+    if (table_entry.key != entry.key || entry.depth >= table_entry.depth) {
+        table_entry = entry;
+    }
+}
+
+void shashki::TranspositionTable::clear()
+{
+    std::fill(this->entries.get(), this->entries.get() + this->mask + 1, TranspositionEntry{0, 0, 0, ScoreBound::NONE, 0});
+}
+
+std::size_t shashki::TranspositionTable::size() const
+{
+    return this->mask + 1;
+}
+
+shashki::SearchConfig::SearchConfig()
+    : singular_extensions(false),
+      singular_depth(4),
+      singular_margin(100) {}
+
+/**
+ * The stage of a SearchFrame:
+ * ENTER means the node has just been entered (its TranspositionEntry is being prefetched),
+ * VERIFY means the other children are searched with a reduced depth to find out whether
+ * the child of the TranspositionEntry is singular,
+ * CHILDREN means the children are generated and searched one after another.
+ */
+enum class FrameStage
+{
+    ENTER,
+    VERIFY,
+    CHILDREN
+};
+
+/**
+ * A SearchFrame is one node of the explicit stack of a SearchState,
+ * it holds everything the recursive negamax would hold in its local variables.
+ * The children are ordered with the child of the TranspositionEntry first, which
+ * is swapped with the first child. ordered_child is the original index of that child.
+ * singular_beta is the score all the other children have to stay below in the VERIFY stage
+ * (verify_score is the best of them so far) for the first child to be extended by one ply.
+ */
+struct SearchFrame
+{
+    shashki::BitBoard               bit_board;
+    shashki::Side                   side;
+    int                             depth;
+    int                             alpha;
+    int                             beta;
+    int                             original_alpha;
+    int                             best_score;
+    std::size_t                     best_child;
+    std::size_t                     ordered_child;
+    std::size_t                     next_child;
+    int                             singular_beta;
+    int                             verify_score;
+    bool                            extend_first_child;
+    unsigned long long              key;
+    std::vector<shashki::BitBoard>  children;
+    FrameStage                      stage;
+};
+
+/**
+ * A SearchState is one search that can be advanced step by step.
+ * The root is searched with iterative deepening: once the iteration of depth has
+ * finished, the next one starts until target_depth is reached, so that the TranspositionTable
+ * already holds the best children of the previous iteration.
+ * frames is the explicit stack (one SearchFrame per ply, reused from node to node)
+ * and ply the index of the current frame, which is -1 as soon as an iteration is finished.
+ * visited_states is the working memory of the move generation, shared by all the frames.
+ * finished is true once the SearchState has no position to search anymore.
+ */
+struct SearchState
+{
+    std::size_t                         position_index;
+    shashki::Position                   position;
+    int                                 depth;
+    int                                 target_depth;
+    std::vector<SearchFrame>            frames;
+    std::vector<shashki::CaptureState>  visited_states;
+    int                                 ply;
+    shashki::SearchResult               result;
+    bool                                finished;
+};
+
+/**
+ * Converts a win or loss score from "plies from the root" to "plies from this node"
+ * for storing it in the table, so that it is valid at any place of the tree.
+ */
+int score_to_table(int score, int ply)
+{
+    return score > WIN_BOUND_SCORE ? score + ply : score < -WIN_BOUND_SCORE ? score - ply : score;
+}
+
+/**
+ * The opposite of "score_to_table()".
+ */
+int score_from_table(int score, int ply)
+{
+    return score > WIN_BOUND_SCORE ? score - ply : score < -WIN_BOUND_SCORE ? score + ply : score;
+}
+
+/**
+ * Maps a child index between the searched order and the order of the generator
+ * (swapping the first child with the ordered_child works both ways).
+ */
+std::size_t swap_child_index(std::size_t index, std::size_t ordered_child)
+{
+    return index == 0 ? ordered_child : index == ordered_child ? 0 : index;
+}
+
+/**
+ * Sets up the frame of the next ply for the given node, prefetches
+ * its TranspositionEntry and makes it the current frame.
+ */
+void enter_node(SearchState& state,
+                const shashki::BitBoard& bit_board,
+                shashki::Side side,
+                int depth,
+                int alpha,
+                int beta,
+                const shashki::TranspositionTable& table)
+{
+    // A child gets its key incrementally from the key of its parent, only the root is hashed completely.
+    unsigned long long key = state.ply >= 0
+        ? shashki::zobrist_hash_after_move(state.frames[state.ply].key, state.frames[state.ply].bit_board, bit_board)
+        : shashki::zobrist_hash(shashki::Position(bit_board, side));
+    SearchFrame& frame = state.frames[++state.ply];
+
+    frame.bit_board = bit_board;
+    frame.side = side;
+    frame.depth = depth;
+    frame.alpha = alpha;
+    frame.beta = beta;
+    frame.key = key;
+    frame.stage = FrameStage::ENTER;
+
+    table.prefetch(frame.key);
+}
+
+/**
+ * Leaves the current node with the given score (from the view of its side to move)
+ * and passes it to the parent frame. Leaving the root finishes the iteration.
+ */
+void leave_node(SearchState& state,
+                int score)
+{
+    if (state.ply == 0) {
+        const SearchFrame& root = state.frames[0];
+        state.result.score = root.side == shashki::Side::WHITE ? score : -score;
+        state.result.best_bit_board = root.stage == FrameStage::CHILDREN && !root.children.empty()
+            ? root.children[root.best_child] : root.bit_board;
+        state.ply = -1;
+        return;
+    }
+
+    SearchFrame& parent = state.frames[--state.ply];
+    int child_score = -score;
+
+    if (parent.stage == FrameStage::VERIFY) {
+        parent.verify_score = std::max(parent.verify_score, child_score);
+        return;
+    }
+
+    if (child_score > parent.best_score) {
+        parent.best_score = child_score;
+        parent.best_child = parent.next_child - 1;
+    }
+
+    parent.alpha = std::max(parent.alpha, child_score);
+}
+
+/**
+ * Advances the search until it enters a new node (and thereby prefetches its
+ * TranspositionEntry) or until its last iteration is finished. Returns false if it is finished.
+ */
+bool advance_search(SearchState& state,
+                    shashki::TranspositionTable& table,
+                    const shashki::SearchConfig& config)
+{
+    // The next iteration of the iterative deepening.
+    if (state.ply < 0 && state.depth < state.target_depth) {
+        state.depth++;
+        enter_node(state, state.position.bit_board, state.position.current_turn, state.depth, -INFINITE_SCORE, INFINITE_SCORE, table);
+        return true;
+    }
+
+    while (state.ply >= 0) {
+        SearchFrame& frame = state.frames[state.ply];
+
+        if (frame.stage == FrameStage::ENTER) {
+            state.result.nodes++;
+
+            // The entry of this node has been prefetched when it was entered.
+            shashki::TranspositionEntry entry = shashki::TranspositionEntry();
+            bool hit = table.probe(frame.key, entry);
+
+            if (hit && state.ply > 0 && entry.depth >= frame.depth) {
+                int score = score_from_table(entry.score, state.ply);
+
+                if (entry.bound == shashki::ScoreBound::EXACT
+                    || (entry.bound == shashki::ScoreBound::LOWER && score >= frame.beta)
+                    || (entry.bound == shashki::ScoreBound::UPPER && score <= frame.alpha)) {
+                    leave_node(state, score);
+                    continue;
+                }
+            }
+
+            if (frame.depth == 0) {
+                leave_node(state, shashki::evaluate_position(shashki::Position(frame.bit_board, frame.side), frame.alpha, frame.beta,
+                                                             &state.result.evaluation_statistics));
+                continue;
+            }
+
+            shashki::generate_distinct_bit_boards_for_position(shashki::Position(frame.bit_board, frame.side), frame.children,
+                                                               state.visited_states);
+
+            // A side that cannot move anymore has lost.
+            if (frame.children.empty()) {
+                leave_node(state, -shashki::SEARCH_WIN_SCORE + state.ply);
+                continue;
+            }
+
+            frame.ordered_child = hit && entry.best_child < frame.children.size() ? entry.best_child : 0;
+            std::swap(frame.children[0], frame.children[frame.ordered_child]);
+
+            frame.original_alpha = frame.alpha;
+            frame.best_score = -INFINITE_SCORE;
+            frame.best_child = 0;
+            frame.next_child = 0;
+            frame.extend_first_child = false;
+            frame.stage = FrameStage::CHILDREN;
+
+            // The child of the TranspositionEntry is a candidate for a singular extension if it has been
+            // at least that good with nearly the same depth (and there is room on the stack for another ply).
+            int entry_score = hit ? score_from_table(entry.score, state.ply) : 0;
+
+            if (config.singular_extensions && hit && frame.children.size() > 1 && frame.depth >= config.singular_depth
+                && entry.best_child < frame.children.size() && entry.bound != shashki::ScoreBound::UPPER
+                && entry.depth >= frame.depth - 3 && std::abs(entry_score) < WIN_BOUND_SCORE
+                && state.ply + frame.depth + 1 < (int) state.frames.size()) {
+                frame.singular_beta = entry_score - config.singular_margin;
+                frame.verify_score = -INFINITE_SCORE;
+                frame.next_child = 1;
+                frame.stage = FrameStage::VERIFY;
+            }
+        }
+
+        // Search all the other children with half the depth and a null window at singular_beta.
+        if (frame.stage == FrameStage::VERIFY) {
+            if (frame.verify_score < frame.singular_beta && frame.next_child < frame.children.size()) {
+                frame.next_child++;
+                enter_node(state, frame.children[frame.next_child - 1], shashki::side_opposite(frame.side),
+                           frame.depth / 2 - 1, -frame.singular_beta, -frame.singular_beta + 1, table);
+                return true;
+            }
+
+            // All of them failed low: the first child is singular.
+            frame.extend_first_child = frame.verify_score < frame.singular_beta;
+            state.result.singular_extensions += frame.extend_first_child ? 1 : 0;
+            frame.next_child = 0;
+            frame.stage = FrameStage::CHILDREN;
+        }
+
+        if (frame.alpha < frame.beta && frame.next_child < frame.children.size()) {
+            int extension = frame.next_child == 0 && frame.extend_first_child ? 1 : 0;
+            frame.next_child++;
+            enter_node(state, frame.children[frame.next_child - 1], shashki::side_opposite(frame.side),
+                       frame.depth - 1 + extension, -frame.beta, -frame.alpha, table);
+            return true;
+        }
+
+        // All children are searched (or one was good enough for a cut-off).
+        shashki::ScoreBound bound = frame.best_score <= frame.original_alpha ? shashki::ScoreBound::UPPER
+            : frame.best_score >= frame.beta ? shashki::ScoreBound::LOWER
+            : shashki::ScoreBound::EXACT;
+
+        table.store(shashki::TranspositionEntry{frame.key, (short) score_to_table(frame.best_score, state.ply),
+                                                (signed char) frame.depth, bound,
+                                                (unsigned short) swap_child_index(frame.best_child, frame.ordered_child)});
+
+        leave_node(state, frame.best_score);
+    }
+
+    return state.depth < state.target_depth;
+}
+
+/**
+ * Starts a new search of the position with the given index in the SearchState.
+ */
+void start_search(SearchState& state,
+                  std::size_t position_index,
+                  const shashki::Position& position,
+                  int depth,
+                  const shashki::TranspositionTable& table)
+{
+    state.position_index = position_index;
+    state.position = position;
+    state.depth = 0;
+    state.target_depth = depth;
+    state.ply = -1;
+    state.finished = false;
+    state.result = shashki::SearchResult{position.bit_board, 0, 0, 0, shashki::EvaluationStatistics{0, 0, 0}};
+
+    enter_node(state, position.bit_board, position.current_turn, 0, -INFINITE_SCORE, INFINITE_SCORE, table);
+}
+
+shashki::SearchResult shashki::search_position(const Position& position,
+                                               int depth,
+                                               TranspositionTable& table,
+                                               const SearchConfig& config)
+{
+    return analyse_positions(std::vector<Position>{position}, depth, table, 1, config)[0];
+}
+
+std::vector<shashki::SearchResult> shashki::analyse_positions(const std::vector<Position>& positions,
+                                                              int depth,
+                                                              TranspositionTable& table,
+                                                              std::size_t interleaved_searches,
+                                                              const SearchConfig& config)
+{
+    if (depth < 0 || depth > MAX_SEARCH_DEPTH) {
+        throw std::invalid_argument("The search depth must be between 0 and " + std::to_string(MAX_SEARCH_DEPTH) + ".");
+    }
+
+    if (config.singular_depth < 2 || config.singular_margin < 0) {
+        throw std::invalid_argument("Singular extensions need a singular_depth of at least 2 and a margin of at least 0.");
+    }
+
+    std::vector<SearchResult> results = std::vector<SearchResult>(positions.size());
+    std::vector<SearchState> states = std::vector<SearchState>(std::min(std::max(interleaved_searches, (std::size_t) 1), positions.size()));
+    std::size_t next_position = 0;
+
+    for (SearchState& state : states) {
+        // Every singular extension adds another ply, up to twice the depth.
+        state.frames = std::vector<SearchFrame>(2 * depth + 1);
+        start_search(state, next_position, positions[next_position], depth, table);
+        next_position++;
+    }
+
+    // Advance the searches in round-robin, every finished one takes the next position.
+    std::size_t active_searches = states.size();
+
+    while (active_searches > 0) {
+        for (SearchState& state : states) {
+            if (state.finished || advance_search(state, table, config)) {
+                continue;
+            }
+
+            results[state.position_index] = state.result;
+
+            if (next_position < positions.size()) {
+                start_search(state, next_position, positions[next_position], depth, table);
+                next_position++;
+            } else {
+                state.finished = true;
+                active_searches--;
+            }
+        }
+    }
+
+    return results;
+}
@@ -0,0 +1,167 @@
+#include "shashki-engine/threats.hpp"
+
+/**
+ * The RayTables are precalculated for the four diagonal directions
+ * (in the order left-up, right-up, left-down, right-down as in the move generation).
+ * rays holds for every board position all the positions from there (exclusive)
+ * to the edge of the board in that direction.
+ * The normal_walls are the positions that cannot move into that direction at all and
+ * the attack_walls the positions that cannot jump into that direction (less than two positions left).
+ * The position_moves are the number of places a step into that direction moves (9/7/-7/-9).
+ */
+struct RayTables
+{
+    unsigned long long  rays[4][64];
+    unsigned long long  normal_walls[4];
+    unsigned long long  attack_walls[4];
+    int                 position_moves[4];
+};
+
+RayTables generate_ray_tables()
+{
+    const int ROW_STEPS[4] = {1, 1, -1, -1};
+    const int COLUMN_STEPS[4] = {1, -1, 1, -1};
+    RayTables ray_tables = RayTables();
+
+    for (int direction = 0; direction < 4; direction++) {
+        ray_tables.position_moves[direction] = ROW_STEPS[direction] * 8 + COLUMN_STEPS[direction];
+
+        for (int position = 0; position < 64; position++) {
+            int row = position / 8 + ROW_STEPS[direction];
+            int column = position % 8 + COLUMN_STEPS[direction];
+            int length = 0;
+
+            while (row >= 0 && row < 8 && column >= 0 && column < 8) {
+                ray_tables.rays[direction][position] = ray_tables.rays[direction][position] | (1ULL << (row * 8 + column));
+                row += ROW_STEPS[direction];
+                column += COLUMN_STEPS[direction];
+                length++;
+            }
+
+            if (length < 1) {
+                ray_tables.normal_walls[direction] = ray_tables.normal_walls[direction] | (1ULL << position);
+            }
+
+            if (length < 2) {
+                ray_tables.attack_walls[direction] = ray_tables.attack_walls[direction] | (1ULL << position);
+            }
+        }
+    }
+
+    return ray_tables;
+}
+
+const RayTables RAY_TABLES = generate_ray_tables();
+
+/**
+ * The attack information of one side before it is combined with
+ * the one of the opponent into the ThreatMaps.
+ * move_squares are the empty positions this side can reach with a normal move.
+ */
+struct SideAttacks
+{
+    unsigned long long  controlled_squares;
+    unsigned long long  capturing_pieces;
+    unsigned long long  move_squares;
+};
+
+/**
+ * Moves all the bits by position_move places (positive to the top, negative to the bottom).
+ */
+unsigned long long shift_bits(unsigned long long bits,
+                              int position_move)
+{
+    return position_move > 0 ? bits << position_move : bits >> -position_move;
+}
+
+/**
+ * Returns the position of the bit that is the closest one
+ * when moving into the direction of position_move.
+ */
+int nearest_position(unsigned long long bits,
+                     int position_move)
+{
+    return position_move > 0 ? __builtin_ctzll(bits) : 63 - __builtin_clzll(bits);
+}
+
+/**
+ * Adds the attack information of one side into one direction to side_attacks.
+ */
+void accumulate_side_attacks(SideAttacks& side_attacks,
+                             const shashki::BitBoard& bit_board,
+                             shashki::Side side,
+                             int direction)
+{
+    unsigned long long men = bit_board.pieces_of_side_and_type(side, shashki::PieceType::MAN);
+    unsigned long long kings = bit_board.pieces_of_side_and_type(side, shashki::PieceType::KING);
+    unsigned long long enemy_bit_board = bit_board.blocking_board_of_side(shashki::side_opposite(side));
+    unsigned long long blocking_bit_board = bit_board.blocking_board();
+    unsigned long long empty_bit_board = ~blocking_bit_board;
+    int position_move = RAY_TABLES.position_moves[direction];
+
+    // The positions whose neighbour in this direction is empty - where a jump over them could land.
+    unsigned long long landing_bit_board = shift_bits(empty_bit_board, -position_move) & ~RAY_TABLES.normal_walls[direction];
+
+    // Men of both sides jump into all directions but only move forward.
+    unsigned long long jumping_men = men & ~RAY_TABLES.attack_walls[direction];
+    side_attacks.controlled_squares |= shift_bits(jumping_men, position_move) & landing_bit_board;
+    side_attacks.capturing_pieces |= jumping_men & shift_bits(enemy_bit_board & landing_bit_board, -position_move);
+
+    if ((position_move > 0) == (side == shashki::Side::WHITE)) {
+        side_attacks.move_squares |= shift_bits(men & ~RAY_TABLES.normal_walls[direction], position_move) & empty_bit_board;
+    }
+
+    // Kings look along their rays up to the first blocking piece.
+    for (; kings != 0; kings = kings & (kings - 1)) {
+        int king_position = __builtin_ctzll(kings);
+        unsigned long long ray = RAY_TABLES.rays[direction][king_position];
+        unsigned long long blockers = ray & blocking_bit_board;
+        unsigned long long reach = ray;
+
+        if (blockers != 0) {
+            int blocker_position = nearest_position(blockers, position_move);
+            reach = ray & ~RAY_TABLES.rays[direction][blocker_position];
+
+            if (enemy_bit_board & landing_bit_board & (1ULL << blocker_position)) {
+                side_attacks.capturing_pieces |= 1ULL << king_position;
+            }
+        }
+
+        side_attacks.move_squares |= reach & empty_bit_board;
+        side_attacks.controlled_squares |= reach & landing_bit_board;
+    }
+}
+
+const shashki::ThreatMap& shashki::Threats::of_side(Side side) const
+{
+    return side == Side::WHITE ? this->white : this->black;
+}
+
+shashki::Threats shashki::calculate_threats(const BitBoard& bit_board)
+{
+    SideAttacks white_attacks = SideAttacks{0, 0, 0};
+    SideAttacks black_attacks = SideAttacks{0, 0, 0};
+
+    for (int direction = 0; direction < 4; direction++) {
+        accumulate_side_attacks(white_attacks, bit_board, Side::WHITE, direction);
+        accumulate_side_attacks(black_attacks, bit_board, Side::BLACK, direction);
+    }
+
+    // Only positions that are not occupied by the own pieces can be controlled.
+    white_attacks.controlled_squares &= ~bit_board.blocking_board_of_side(Side::WHITE);
+    black_attacks.controlled_squares &= ~bit_board.blocking_board_of_side(Side::BLACK);
+
+    ThreatMap white = ThreatMap{
+        black_attacks.controlled_squares & bit_board.blocking_board_of_side(Side::WHITE),
+        white_attacks.controlled_squares,
+        white_attacks.move_squares & ~black_attacks.controlled_squares,
+        white_attacks.capturing_pieces};
+
+    ThreatMap black = ThreatMap{
+        white_attacks.controlled_squares & bit_board.blocking_board_of_side(Side::BLACK),
+        black_attacks.controlled_squares,
+        black_attacks.move_squares & ~white_attacks.controlled_squares,
+        black_attacks.capturing_pieces};
+
+    return Threats{white, black};
+}
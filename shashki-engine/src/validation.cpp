@@ -0,0 +1,186 @@
+#include "shashki-engine/validation.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include "shashki-engine/move-generation.hpp"
+#include "internal.hpp"
+
+/**
+ * The number of GameRecords a thread takes at once when validating in bulk.
+ * Taking several games at once keeps the threads from fighting over the shared index.
+ */
+const std::size_t VALIDATION_CHUNK_SIZE = 64;
+
+shashki::PackedMove::PackedMove(int source_position,
+                                int target_position,
+                                unsigned long long captures)
+    : captures(captures),
+      squares((unsigned short) (source_position | (target_position << 6))) {}
+
+bool shashki::PackedMove::operator==(const PackedMove& packed_move) const
+{
+    return this->captures == packed_move.captures
+        && this->squares == packed_move.squares;
+}
+
+int shashki::PackedMove::source_position() const
+{
+    return this->squares & 0b111111;
+}
+
+int shashki::PackedMove::target_position() const
+{
+    return (this->squares >> 6) & 0b111111;
+}
+
+shashki::GameRecord::GameRecord()
+    : start_position(Position()),
+      moves(std::vector<PackedMove>()),
+      result(GameResult::UNKNOWN) {}
+
+/**
+ * Returns a copy of the BitBoard where the given bits are removed from all side/type combinations.
+ */
+shashki::BitBoard bit_board_without(const shashki::BitBoard& bit_board,
+                                    unsigned long long bits)
+{
+    return shashki::BitBoard(bit_board.white_men & ~bits,
+                             bit_board.white_kings & ~bits,
+                             bit_board.black_men & ~bits,
+                             bit_board.black_kings & ~bits);
+}
+
+shashki::PackedMove shashki::packed_move_between(const Position& position,
+                                                 const BitBoard& target_bit_board)
+{
+    std::vector<BitBoard> bit_boards = std::vector<BitBoard>();
+    return packed_move_between(position, target_bit_board, bit_boards);
+}
+
+shashki::PackedMove shashki::packed_move_between(const Position& position,
+                                                 const BitBoard& target_bit_board,
+                                                 std::vector<BitBoard>& bit_boards)
+{
+    Side side = position.current_turn;
+    unsigned long long source_pieces = position.bit_board.blocking_board_of_side(side);
+    unsigned long long target_pieces = target_bit_board.blocking_board_of_side(side);
+    unsigned long long captures = position.bit_board.blocking_board_of_side(side_opposite(side))
+                                & ~target_bit_board.blocking_board_of_side(side_opposite(side));
+
+    if (source_pieces != target_pieces) {
+        return PackedMove(__builtin_ctzll(source_pieces & ~target_pieces), __builtin_ctzll(target_pieces & ~source_pieces), captures);
+    }
+
+    // A combo that ended on its source position again.
+    // Find the piece that is able to jump exactly these pieces.
+    for (unsigned long long pieces = source_pieces; pieces != 0; pieces = pieces & (pieces - 1)) {
+        int piece_position = __builtin_ctzll(pieces);
+        Piece piece = Piece(side, position.bit_board.piece_type_on_position(piece_position), piece_position);
+        generate_attack_bit_boards_for_piece(position.bit_board, piece, bit_boards);
+
+        if (std::find(bit_boards.begin(), bit_boards.end(), target_bit_board) != bit_boards.end()) {
+            return PackedMove(piece_position, piece_position, captures);
+        }
+    }
+
+    throw std::invalid_argument("The target BitBoard is not the result of a move of the position.");
+}
+
+bool shashki::execute_packed_move(Position& position,
+                                  const PackedMove& packed_move)
+{
+    std::vector<BitBoard> bit_boards = std::vector<BitBoard>();
+    return execute_packed_move(position, packed_move, bit_boards);
+}
+
+bool shashki::execute_packed_move(Position& position,
+                                  const PackedMove& packed_move,
+                                  std::vector<BitBoard>& bit_boards)
+{
+    const BitBoard& bit_board = position.bit_board;
+    Side side = position.current_turn;
+    int source_position = packed_move.source_position();
+    int target_position = packed_move.target_position();
+
+    // 1. The moving piece must belong to the side in turn and the target must be empty.
+    //    Only a combo can end on its (by then empty) source position.
+    if (!(bit_board.blocking_board_of_side(side) & (1ULL << source_position))) {
+        return false;
+    }
+
+    if ((bit_board.blocking_board() & (1ULL << target_position)) && target_position != source_position) {
+        return false;
+    }
+
+    // 2. Generate the paths of only the moving piece. Normal moves are only legal
+    //    if no piece of the side can jump, as jumping in Shashki is obligatory.
+    Piece piece = Piece(side, bit_board.piece_type_on_position(source_position), source_position);
+
+    if (packed_move.captures != 0) {
+        generate_attack_bit_boards_for_piece(bit_board, piece, bit_boards);
+    } else if (!side_can_capture(bit_board, side)) {
+        generate_normal_bit_boards_for_piece(bit_board, piece, bit_boards);
+    } else {
+        bit_boards.clear();
+    }
+
+    // 3. The move is legal if one of the paths results into the BitBoard described by the PackedMove.
+    //    The piece arrives as a Man or, if it is a King already or was promoted on its way, as a King.
+    BitBoard remaining_bit_board = bit_board_without(bit_board, (1ULL << source_position) | packed_move.captures);
+    BitBoard man_bit_board = remaining_bit_board;
+    BitBoard king_bit_board = remaining_bit_board;
+
+    if (side == Side::WHITE) {
+        man_bit_board.white_men = man_bit_board.white_men | (1ULL << target_position);
+        king_bit_board.white_kings = king_bit_board.white_kings | (1ULL << target_position);
+    } else {
+        man_bit_board.black_men = man_bit_board.black_men | (1ULL << target_position);
+        king_bit_board.black_kings = king_bit_board.black_kings | (1ULL << target_position);
+    }
+
+    for (const BitBoard& target_bit_board : bit_boards) {
+        if (target_bit_board == man_bit_board || target_bit_board == king_bit_board) {
+            position = Position(target_bit_board, side_opposite(side));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int shashki::first_illegal_ply(const GameRecord& game_record)
+{
+    std::vector<BitBoard> bit_boards = std::vector<BitBoard>();
+    return first_illegal_ply(game_record, bit_boards);
+}
+
+int shashki::first_illegal_ply(const GameRecord& game_record,
+                               std::vector<BitBoard>& bit_boards)
+{
+    Position position = game_record.start_position;
+
+    for (std::size_t ply = 0; ply < game_record.moves.size(); ply++) {
+        if (!execute_packed_move(position, game_record.moves[ply], bit_boards)) {
+            return (int) ply;
+        }
+    }
+
+    return -1;
+}
+
+std::vector<int> shashki::validate_game_records(const std::vector<GameRecord>& game_records,
+                                                unsigned int thread_count)
+{
+    std::vector<int> first_illegal_plies = std::vector<int>(game_records.size(), -1);
+    std::vector<std::vector<BitBoard>> thread_bit_boards = std::vector<std::vector<BitBoard>>(std::max(thread_count, 1U));
+
+    // The results are written into distinct places so no further synchronisation is needed.
+    process_in_chunks(game_records.size(), VALIDATION_CHUNK_SIZE, thread_count,
+                      [&](unsigned int thread_index, std::size_t first, std::size_t last) {
+        for (std::size_t index = first; index < last; index++) {
+            first_illegal_plies[index] = first_illegal_ply(game_records[index], thread_bit_boards[thread_index]);
+        }
+    });
+
+    return first_illegal_plies;
+}
@@ -0,0 +1,112 @@
+#include "shashki-engine/zobrist.hpp"
+
+#include <array>
+
+/**
+ * The ZobristKeys hold one random 64-bit key for every side/type combination
+ * on every board position and one for the side to move.
+ */
+struct ZobristKeys
+{
+    std::array<unsigned long long, 64>  white_men;
+    std::array<unsigned long long, 64>  white_kings;
+    std::array<unsigned long long, 64>  black_men;
+    std::array<unsigned long long, 64>  black_kings;
+    unsigned long long                  black_to_move;
+};
+
+/**
+ * Generates the ZobristKeys with the splitmix64 generator from a fixed seed.
+ * The seed must never change as hashes may be stored persistently (e.g. in opening trees).
+ * The keys are generated at compile time, so they are ready before any static initialisation
+ * (e.g. of a Game, which hashes its start position).
+ */
+constexpr ZobristKeys generate_zobrist_keys()
+{
+    ZobristKeys zobrist_keys = ZobristKeys();
+    unsigned long long state = 0x5368617368696b69ULL;
+
+    auto next_key = [&]() {
+        state += 0x9e3779b97f4a7c15ULL;
+        unsigned long long key = state;
+        key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+        return key ^ (key >> 31);
+    };
+
+    for (int position = 0; position < 64; position++) {
+        zobrist_keys.white_men[position] = next_key();
+        zobrist_keys.white_kings[position] = next_key();
+        zobrist_keys.black_men[position] = next_key();
+        zobrist_keys.black_kings[position] = next_key();
+    }
+
+    zobrist_keys.black_to_move = next_key();
+
+    return zobrist_keys;
+}
+
+constexpr ZobristKeys ZOBRIST_KEYS = generate_zobrist_keys();
+
+/**
+ * XOR combines the keys of all the set bits of one side/type combination.
+ */
+unsigned long long zobrist_hash_part(unsigned long long bit_board_part,
+                                     const std::array<unsigned long long, 64>& keys)
+{
+    unsigned long long hash = 0;
+
+    for (; bit_board_part != 0; bit_board_part = bit_board_part & (bit_board_part - 1)) {
+        hash = hash ^ keys[__builtin_ctzll(bit_board_part)];
+    }
+
+    return hash;
+}
+
+unsigned long long shashki::zobrist_hash(const BitBoard& bit_board)
+{
+    unsigned long long hash = 0;
+
+    hash = hash ^ zobrist_hash_part(bit_board.white_men, ZOBRIST_KEYS.white_men);
+    hash = hash ^ zobrist_hash_part(bit_board.white_kings, ZOBRIST_KEYS.white_kings);
+    hash = hash ^ zobrist_hash_part(bit_board.black_men, ZOBRIST_KEYS.black_men);
+    hash = hash ^ zobrist_hash_part(bit_board.black_kings, ZOBRIST_KEYS.black_kings);
+
+    return hash;
+}
+
+unsigned long long shashki::zobrist_hash(const Position& position)
+{
+    unsigned long long hash = zobrist_hash(position.bit_board);
+
+    if (position.current_turn == shashki::Side::BLACK) {
+        hash = hash ^ ZOBRIST_KEYS.black_to_move;
+    }
+
+    return hash;
+}
+
+unsigned long long shashki::zobrist_hash(const Game& game)
+{
+    return game.get_zobrist_key();
+}
+
+unsigned long long shashki::zobrist_hash_update(unsigned long long hash,
+                                                const BitBoard& source_bit_board,
+                                                const BitBoard& target_bit_board)
+{
+    // The keys of pieces on both BitBoards cancel each other out, so only the changed bits are combined.
+    hash = hash ^ zobrist_hash_part(source_bit_board.white_men ^ target_bit_board.white_men, ZOBRIST_KEYS.white_men);
+    hash = hash ^ zobrist_hash_part(source_bit_board.white_kings ^ target_bit_board.white_kings, ZOBRIST_KEYS.white_kings);
+    hash = hash ^ zobrist_hash_part(source_bit_board.black_men ^ target_bit_board.black_men, ZOBRIST_KEYS.black_men);
+    hash = hash ^ zobrist_hash_part(source_bit_board.black_kings ^ target_bit_board.black_kings, ZOBRIST_KEYS.black_kings);
+
+    return hash;
+}
+
+unsigned long long shashki::zobrist_hash_after_move(unsigned long long hash,
+                                                    const BitBoard& source_bit_board,
+                                                    const BitBoard& target_bit_board)
+{
+    return zobrist_hash_update(hash, source_bit_board, target_bit_board) ^ ZOBRIST_KEYS.black_to_move;
+}
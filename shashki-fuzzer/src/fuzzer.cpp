@@ -0,0 +1,404 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <iterator>
+#include "shashki-engine/common.hpp"
+#include "shashki-engine/move-generation.hpp"
+#include "shashki-engine/validation.hpp"
+#include "shashki-engine/threats.hpp"
+#include "shashki-engine/zobrist.hpp"
+
+/**
+ * The bits of all the dark squares - the only squares pieces can stand on.
+ */
+const unsigned long long DARK_SQUARES = 0x55AA55AA55AA55AAULL;
+const unsigned long long WHITE_PROMOTION_ROW = 0xFF00000000000000ULL;
+const unsigned long long BLACK_PROMOTION_ROW = 0x00000000000000FFULL;
+
+const unsigned long long DEFAULT_SEED = 2021;
+const unsigned long long DEFAULT_POSITIONS = 1000000;
+const unsigned long long PROGRESS_INTERVAL = 100000;
+
+/**
+ * Orders BitBoards so that two lists of BitBoards can be compared as sets.
+ */
+bool bit_board_less(const shashki::BitBoard& first, const shashki::BitBoard& second)
+{
+    return std::tie(first.white_men, first.white_kings, first.black_men, first.black_kings)
+         < std::tie(second.white_men, second.white_kings, second.black_men, second.black_kings);
+}
+
+/**
+ * Collects the resulting BitBoard of every move path of a move (recursively over the follow_moves).
+ */
+void collect_move_path_bit_boards(std::vector<shashki::BitBoard>& bit_boards, const shashki::Move& move)
+{
+    if (move.get_follow_moves().empty()) {
+        bit_boards.push_back(move.get_target_bit_board());
+    } else {
+        for (const shashki::Move& follow_move : move.get_follow_moves()) {
+            collect_move_path_bit_boards(bit_boards, follow_move);
+        }
+    }
+}
+
+/**
+ * The resulting BitBoards of the recursive reference generator, sorted.
+ */
+std::vector<shashki::BitBoard> reference_bit_boards(const shashki::Position& position)
+{
+    std::vector<shashki::BitBoard> bit_boards = std::vector<shashki::BitBoard>();
+
+    for (const shashki::Move& move : shashki::generate_moves_for_side(position.bit_board, position.current_turn)) {
+        collect_move_path_bit_boards(bit_boards, move);
+    }
+
+    std::sort(bit_boards.begin(), bit_boards.end(), bit_board_less);
+    return bit_boards;
+}
+
+/**
+ * The resulting BitBoards of the optimised generator, sorted.
+ */
+std::vector<shashki::BitBoard> optimised_bit_boards(const shashki::Position& position)
+{
+    std::vector<shashki::BitBoard> bit_boards = shashki::generate_bit_boards_for_position(position);
+    std::sort(bit_boards.begin(), bit_boards.end(), bit_board_less);
+    return bit_boards;
+}
+
+/**
+ * Returns true if the optimised generator and the optimised legality checks agree
+ * with the reference generator: the same resulting BitBoards (and path count, and
+ * the same distinct BitBoards without duplicates), the same answer to
+ * "is a jump possible" and every reference move path is accepted when packed
+ * (and the incremental Zobrist hash of its result equals the complete one).
+ */
+bool generators_agree(const shashki::Position& position)
+{
+    std::vector<shashki::Move> moves = shashki::generate_moves_for_side(position.bit_board, position.current_turn);
+    std::vector<shashki::BitBoard> reference = reference_bit_boards(position);
+
+    if (reference != optimised_bit_boards(position) || shashki::count_move_paths(position) != reference.size()) {
+        return false;
+    }
+
+    std::vector<shashki::BitBoard> distinct = std::vector<shashki::BitBoard>();
+    shashki::generate_distinct_bit_boards_for_position(position, distinct);
+    std::sort(distinct.begin(), distinct.end(), bit_board_less);
+
+    std::vector<shashki::BitBoard> reference_distinct = reference;
+    reference_distinct.erase(std::unique(reference_distinct.begin(), reference_distinct.end()), reference_distinct.end());
+
+    if (distinct != reference_distinct) {
+        return false;
+    }
+
+    bool reference_can_capture = !moves.empty() && moves.front().get_attacked_piece().has_value();
+
+    if (reference_can_capture != shashki::side_can_capture(position.bit_board, position.current_turn)) {
+        return false;
+    }
+
+    // The first jumps of the reference moves must be exactly the capturing pieces of the side
+    // in turn and the attacked pieces of the opponent in its ThreatMap.
+    unsigned long long capturing_pieces = 0;
+    unsigned long long attacked_pieces = 0;
+
+    for (const shashki::Move& move : reference_can_capture ? moves : std::vector<shashki::Move>()) {
+        capturing_pieces = capturing_pieces | (1ULL << move.get_moving_piece().position);
+        attacked_pieces = attacked_pieces | (1ULL << move.get_attacked_piece()->position);
+    }
+
+    shashki::Threats threats = shashki::calculate_threats(position.bit_board);
+
+    if (threats.of_side(position.current_turn).capturing_pieces != capturing_pieces
+        || threats.of_side(shashki::side_opposite(position.current_turn)).attacked_pieces != attacked_pieces) {
+        return false;
+    }
+
+    unsigned long long hash = shashki::zobrist_hash(position);
+
+    return std::all_of(reference.begin(), reference.end(), [&](const shashki::BitBoard& bit_board) {
+        shashki::Position target_position = position;
+        return shashki::execute_packed_move(target_position, shashki::packed_move_between(position, bit_board))
+            && target_position.bit_board == bit_board
+            && shashki::zobrist_hash_after_move(hash, position.bit_board, bit_board) == shashki::zobrist_hash(target_position);
+    });
+}
+
+/**
+ * Picks a random set bit of the given mask and returns it as a single bit (0 if the mask is empty).
+ */
+unsigned long long random_bit(std::mt19937_64& random_number_generator, unsigned long long mask)
+{
+    std::vector<int> positions = std::vector<int>();
+
+    for (int bit = 0; bit < 64; bit++) {
+        if (mask & (1ULL << bit)) {
+            positions.push_back(bit);
+        }
+    }
+
+    if (positions.empty()) {
+        return 0;
+    }
+
+    std::uniform_int_distribution<std::size_t> random_distribution = std::uniform_int_distribution<std::size_t>(0, positions.size() - 1);
+    return 1ULL << positions[random_distribution(random_number_generator)];
+}
+
+/**
+ * Places count pieces randomly onto free squares of the allowed mask.
+ */
+unsigned long long place_random_pieces(std::mt19937_64& random_number_generator,
+                                       shashki::BitBoard& bit_board,
+                                       unsigned long long allowed,
+                                       int count)
+{
+    unsigned long long pieces = 0;
+
+    for (int placed = 0; placed < count; placed++) {
+        pieces = pieces | random_bit(random_number_generator, allowed & ~bit_board.blocking_board() & ~pieces);
+    }
+
+    return pieces;
+}
+
+shashki::Side random_side(std::mt19937_64& random_number_generator)
+{
+    return random_number_generator() & 1 ? shashki::Side::WHITE : shashki::Side::BLACK;
+}
+
+/**
+ * A position reached by random moves from the start constellation.
+ */
+shashki::Position random_game_position(std::mt19937_64& random_number_generator)
+{
+    shashki::Position position = shashki::Position();
+    int plies = std::uniform_int_distribution<int>(0, 100)(random_number_generator);
+
+    for (int ply = 0; ply < plies; ply++) {
+        std::vector<shashki::BitBoard> bit_boards = shashki::generate_bit_boards_for_position(position);
+
+        if (bit_boards.empty()) {
+            break;
+        }
+
+        std::uniform_int_distribution<std::size_t> random_distribution = std::uniform_int_distribution<std::size_t>(0, bit_boards.size() - 1);
+        position = shashki::Position(bit_boards[random_distribution(random_number_generator)], shashki::side_opposite(position.current_turn));
+    }
+
+    return position;
+}
+
+/**
+ * A position with random men and kings of both sides scattered over the dark squares.
+ */
+shashki::Position random_scattered_position(std::mt19937_64& random_number_generator)
+{
+    std::uniform_int_distribution<int> men_distribution = std::uniform_int_distribution<int>(0, 12);
+    std::uniform_int_distribution<int> kings_distribution = std::uniform_int_distribution<int>(0, 3);
+    shashki::BitBoard bit_board = shashki::BitBoard(0, 0, 0, 0);
+
+    bit_board.white_men = place_random_pieces(random_number_generator, bit_board, DARK_SQUARES & ~WHITE_PROMOTION_ROW, men_distribution(random_number_generator));
+    bit_board.black_men = place_random_pieces(random_number_generator, bit_board, DARK_SQUARES & ~BLACK_PROMOTION_ROW, men_distribution(random_number_generator));
+    bit_board.white_kings = place_random_pieces(random_number_generator, bit_board, DARK_SQUARES, kings_distribution(random_number_generator));
+    bit_board.black_kings = place_random_pieces(random_number_generator, bit_board, DARK_SQUARES, kings_distribution(random_number_generator));
+
+    return shashki::Position(bit_board, random_side(random_number_generator));
+}
+
+/**
+ * An adversarial position for flying kings: one or two kings of the side to move
+ * against many enemy pieces scattered away from the edges, so that long
+ * capture paths with many branches are possible.
+ */
+shashki::Position flying_king_position(std::mt19937_64& random_number_generator)
+{
+    const unsigned long long INNER_SQUARES = DARK_SQUARES & 0x007E7E7E7E7E7E00ULL;
+    shashki::Side side = random_side(random_number_generator);
+    shashki::BitBoard bit_board = shashki::BitBoard(0, 0, 0, 0);
+
+    unsigned long long enemies = place_random_pieces(random_number_generator, bit_board, INNER_SQUARES,
+                                                     std::uniform_int_distribution<int>(4, 12)(random_number_generator));
+    unsigned long long enemy_kings = random_bit(random_number_generator, enemies) & (random_number_generator() & 1 ? ~0ULL : 0ULL);
+
+    if (side == shashki::Side::WHITE) {
+        bit_board.black_men = enemies & ~enemy_kings & ~BLACK_PROMOTION_ROW;
+        bit_board.black_kings = enemy_kings;
+        bit_board.white_kings = place_random_pieces(random_number_generator, bit_board, DARK_SQUARES,
+                                                    std::uniform_int_distribution<int>(1, 2)(random_number_generator));
+    } else {
+        bit_board.white_men = enemies & ~enemy_kings & ~WHITE_PROMOTION_ROW;
+        bit_board.white_kings = enemy_kings;
+        bit_board.black_kings = place_random_pieces(random_number_generator, bit_board, DARK_SQUARES,
+                                                    std::uniform_int_distribution<int>(1, 2)(random_number_generator));
+    }
+
+    return shashki::Position(bit_board, side);
+}
+
+/**
+ * An adversarial position for promotions during a combo: men of the side to move
+ * close to the promotion row with enemy pieces in front of and around them, so that
+ * a capture lands on the promotion row and continues as a King.
+ */
+shashki::Position mid_capture_promotion_position(std::mt19937_64& random_number_generator)
+{
+    shashki::Side side = random_side(random_number_generator);
+    bool white = side == shashki::Side::WHITE;
+    const unsigned long long ATTACKER_ROWS = white ? 0x0000FFFF00000000ULL : 0x00000000FFFF0000ULL;
+    const unsigned long long ENEMY_ROWS = white ? 0x00FFFFFFFFFF0000ULL : 0x0000FFFFFFFFFF00ULL;
+    shashki::BitBoard bit_board = shashki::BitBoard(0, 0, 0, 0);
+
+    unsigned long long attackers = place_random_pieces(random_number_generator, bit_board, DARK_SQUARES & ATTACKER_ROWS,
+                                                       std::uniform_int_distribution<int>(1, 3)(random_number_generator));
+    (white ? bit_board.white_men : bit_board.black_men) = attackers;
+
+    unsigned long long enemies = place_random_pieces(random_number_generator, bit_board, DARK_SQUARES & ENEMY_ROWS,
+                                                     std::uniform_int_distribution<int>(3, 10)(random_number_generator));
+    (white ? bit_board.black_men : bit_board.white_men) = enemies;
+
+    return shashki::Position(bit_board, side);
+}
+
+/**
+ * Generates the next fuzzing position, alternating between the random and the adversarial kinds.
+ */
+shashki::Position next_position(std::mt19937_64& random_number_generator, unsigned long long index)
+{
+    switch (index % 4) {
+        case 0:
+            return random_game_position(random_number_generator);
+        case 1:
+            return random_scattered_position(random_number_generator);
+        case 2:
+            return flying_king_position(random_number_generator);
+        default:
+            return mid_capture_promotion_position(random_number_generator);
+    }
+}
+
+/**
+ * Shrinks a failing position by removing pieces one by one
+ * as long as the generators still disagree.
+ */
+shashki::Position minimise_position(shashki::Position position)
+{
+    bool shrunk = true;
+
+    while (shrunk) {
+        shrunk = false;
+
+        for (int bit = 0; bit < 64; bit++) {
+            shashki::Position candidate = position;
+            unsigned long long removed_bits = ~(1ULL << bit);
+
+            candidate.bit_board.white_men = candidate.bit_board.white_men & removed_bits;
+            candidate.bit_board.white_kings = candidate.bit_board.white_kings & removed_bits;
+            candidate.bit_board.black_men = candidate.bit_board.black_men & removed_bits;
+            candidate.bit_board.black_kings = candidate.bit_board.black_kings & removed_bits;
+
+            if (!(candidate == position) && !generators_agree(candidate)) {
+                position = candidate;
+                shrunk = true;
+            }
+        }
+    }
+
+    return position;
+}
+
+void print_bit_board(const shashki::BitBoard& bit_board)
+{
+    for (int row = 7; row >= 0; row--) {
+        std::cout << "    " << row + 1 << " ";
+
+        for (int column = 7; column >= 0; column--) {
+            unsigned long long bit = 1ULL << (row * 8 + column);
+
+            if (bit & bit_board.white_men) {
+                std::cout << " o";
+            } else if (bit & bit_board.white_kings) {
+                std::cout << " Ø";
+            } else if (bit & bit_board.black_men) {
+                std::cout << " +";
+            } else if (bit & bit_board.black_kings) {
+                std::cout << " #";
+            } else {
+                std::cout << " .";
+            }
+        }
+
+        std::cout << "\n";
+    }
+
+    std::cout << "       A B C D E F G H\n";
+    std::cout << std::hex << "    BitBoard(0x" << bit_board.white_men << ", 0x" << bit_board.white_kings
+              << ", 0x" << bit_board.black_men << ", 0x" << bit_board.black_kings << ")\n" << std::dec;
+}
+
+void print_failure(const shashki::Position& position)
+{
+    std::vector<shashki::BitBoard> reference = reference_bit_boards(position);
+    std::vector<shashki::BitBoard> optimised = optimised_bit_boards(position);
+    std::vector<shashki::BitBoard> only_reference = std::vector<shashki::BitBoard>();
+    std::vector<shashki::BitBoard> only_optimised = std::vector<shashki::BitBoard>();
+
+    std::set_difference(reference.begin(), reference.end(), optimised.begin(), optimised.end(), std::back_inserter(only_reference), bit_board_less);
+    std::set_difference(optimised.begin(), optimised.end(), reference.begin(), reference.end(), std::back_inserter(only_optimised), bit_board_less);
+
+    std::cout << "Minimised failing position (" << (position.current_turn == shashki::Side::WHITE ? "White" : "Black") << " to move):\n";
+    print_bit_board(position.bit_board);
+    std::cout << "Reference generator: " << reference.size() << " move paths, optimised generator: " << optimised.size() << " move paths.\n";
+    std::cout << "Optimised jump detection: " << (shashki::side_can_capture(position.bit_board, position.current_turn) ? "can" : "cannot") << " jump.\n";
+    std::cout << std::hex << "Capturing pieces: 0x" << shashki::calculate_threats(position.bit_board).of_side(position.current_turn).capturing_pieces
+              << ", attacked pieces: 0x" << shashki::calculate_threats(position.bit_board).of_side(shashki::side_opposite(position.current_turn)).attacked_pieces
+              << "\n" << std::dec;
+
+    for (const shashki::BitBoard& bit_board : only_reference) {
+        std::cout << "Only reached by the reference generator:\n";
+        print_bit_board(bit_board);
+    }
+
+    for (const shashki::BitBoard& bit_board : only_optimised) {
+        std::cout << "Only reached by the optimised generator:\n";
+        print_bit_board(bit_board);
+    }
+}
+
+/**
+ * Usage: shashki-fuzzer [seed] [positions]
+ */
+int main(int argc, char* argv[])
+{
+    unsigned long long seed = argc > 1 ? std::stoull(argv[1]) : DEFAULT_SEED;
+    unsigned long long positions = argc > 2 ? std::stoull(argv[2]) : DEFAULT_POSITIONS;
+
+    std::cout << "- Shashki-Engine move-generation fuzzer -\n\n";
+    std::cout << "Comparing the reference and the optimised generator on " << positions << " positions (seed " << seed << ")...\n";
+
+    std::mt19937_64 random_number_generator = std::mt19937_64(seed);
+
+    for (unsigned long long index = 0; index < positions; index++) {
+        shashki::Position position = next_position(random_number_generator, index);
+
+        if (!generators_agree(position)) {
+            std::cout << "\nGenerators disagree on position " << index << ".\n";
+            print_failure(minimise_position(position));
+            return 1;
+        }
+
+        if ((index + 1) % PROGRESS_INTERVAL == 0) {
+            std::cout << index + 1 << " positions checked.\n";
+        }
+    }
+
+    std::cout << "Fuzzing finished, the generators agree on all positions!\n";
+    return 0;
+}